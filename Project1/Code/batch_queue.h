@@ -0,0 +1,60 @@
+#ifndef BATCH_QUEUE_H
+#define BATCH_QUEUE_H
+
+#include <cstddef>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <utility>
+
+// Bounded ring buffer handing whole batches from one producer thread to one
+// consumer thread. Items are moved in and out, so batch storage is never copied;
+// locking is per batch, not per record.
+
+template <typename T>
+class BatchQueue {
+public:
+    explicit BatchQueue(std::size_t capacity) : slots_(capacity ? capacity : 1) {}
+
+    // Blocks while full. Returns false if the queue was closed (item dropped).
+    bool push(T&& item) {
+        std::unique_lock<std::mutex> lk(mu_);
+        not_full_.wait(lk, [&]{ return count_ < slots_.size() || closed_; });
+        if (closed_) return false;
+        slots_[(head_ + count_) % slots_.size()] = std::move(item);
+        ++count_;
+        not_empty_.notify_one();
+        return true;
+    }
+
+    // Blocks while empty. Returns false once the queue is closed and drained.
+    bool pop(T& out) {
+        std::unique_lock<std::mutex> lk(mu_);
+        not_empty_.wait(lk, [&]{ return count_ > 0 || closed_; });
+        if (count_ == 0) return false;
+        out = std::move(slots_[head_]);
+        head_ = (head_ + 1) % slots_.size();
+        --count_;
+        not_full_.notify_one();
+        return true;
+    }
+
+    // Wake both sides; pending items can still be popped.
+    void close() {
+        std::lock_guard<std::mutex> lk(mu_);
+        closed_ = true;
+        not_full_.notify_all();
+        not_empty_.notify_all();
+    }
+
+private:
+    std::vector<T>          slots_;
+    std::size_t             head_   = 0;
+    std::size_t             count_  = 0;
+    bool                    closed_ = false;
+    std::mutex              mu_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+};
+
+#endif // BATCH_QUEUE_H
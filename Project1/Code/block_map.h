@@ -0,0 +1,71 @@
+#ifndef BLOCK_MAP_H
+#define BLOCK_MAP_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Block address -> 32-bit value, open addressing (linear probing) that grows
+// to keep the load factor <= 0.5. Used by the trace analyses (stack distance,
+// miss classification, reuse distance) to remember per-block history across
+// an unbounded footprint; the value kNone is reserved.
+class BlockMap {
+public:
+    BlockMap() { rehash_(1u << 16); }
+
+    // Returns the value stored for 'key' (kNone if absent) and stores 'val'.
+    uint32_t exchange(uint32_t key, uint32_t val) {
+        if (2 * (size_ + 1) > keys_.size()) rehash_(keys_.size() * 2);
+        std::size_t i = home_(key);
+        while (vals_[i] != kNone) {
+            if (keys_[i] == key) {
+                const uint32_t old = vals_[i];
+                vals_[i] = val;
+                return old;
+            }
+            i = (i + 1) & mask_;
+        }
+        keys_[i] = key;
+        vals_[i] = val;
+        ++size_;
+        return kNone;
+    }
+
+    // Number of distinct keys stored.
+    std::size_t size() const { return size_; }
+
+    static constexpr uint32_t kNone = 0xFFFFFFFFu;
+
+private:
+    std::size_t home_(uint32_t key) const {
+        return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ULL) >> shift_);
+    }
+
+    void rehash_(std::size_t cap) {
+        std::vector<uint32_t> old_keys, old_vals;
+        old_keys.swap(keys_);
+        old_vals.swap(vals_);
+        keys_.assign(cap, 0);
+        vals_.assign(cap, kNone);
+        mask_  = cap - 1;
+        shift_ = 64;
+        for (std::size_t c = cap; c > 1; c >>= 1) --shift_;
+        size_ = 0;
+        for (std::size_t j = 0; j < old_keys.size(); ++j) {
+            if (old_vals[j] == kNone) continue;
+            std::size_t i = home_(old_keys[j]);
+            while (vals_[i] != kNone) i = (i + 1) & mask_;
+            keys_[i] = old_keys[j];
+            vals_[i] = old_vals[j];
+            ++size_;
+        }
+    }
+
+    std::vector<uint32_t> keys_;
+    std::vector<uint32_t> vals_;
+    std::size_t           mask_  = 0;
+    uint32_t              shift_ = 0;
+    std::size_t           size_  = 0;
+};
+
+#endif // BLOCK_MAP_H
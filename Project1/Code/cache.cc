@@ -5,13 +5,14 @@
  * Updated:     2025-09-21
  * Version:     1.1
  *
- * Description: Implements the Cache class with WBWA write policy, LRU replacement,
- *              allocation, and writeback logic. Used for both L1 and L2 caches.
+ * Description: Implements the Cache class with WBWA write policy, LRU (or
+ *              pluggable) replacement, allocation, and writeback logic. Used for both L1 and L2 caches.
  *              Includes contents printing to match validation formatting.
  ***********************************************************************************/
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <inttypes.h>
 #include <cassert>
 #include <cmath>
@@ -25,6 +26,7 @@
 #include <algorithm>
 
 #include "cache.h"
+#include "cache_fixed.h"
 
 static inline uint32_t ilog2_uint32(uint32_t x) {
     // precondition: x is a power of two
@@ -37,7 +39,72 @@ static inline uint32_t ilog2_uint32(uint32_t x) {
 AccessStats::AccessStats()
 : reads(0), read_misses(0), writes(0), write_misses(0),
   writebacks(0), memory_reads(0), memory_writes(0),
-  pref_issued(0), pref_useful(0), pref_late(0) {}
+  pref_issued(0), pref_useful(0), pref_late(0),
+  back_invalidations(0), victim_fills(0),
+  write_throughs(0), wbuf_coalesced(0),
+  victim_probes(0), victim_hits(0) {}
+
+AccessStats& AccessStats::operator+=(const AccessStats& o) {
+    reads         += o.reads;
+    read_misses   += o.read_misses;
+    writes        += o.writes;
+    write_misses  += o.write_misses;
+    writebacks    += o.writebacks;
+    memory_reads  += o.memory_reads;
+    memory_writes += o.memory_writes;
+    pref_issued   += o.pref_issued;
+    pref_useful   += o.pref_useful;
+    pref_late     += o.pref_late;
+    back_invalidations += o.back_invalidations;
+    victim_fills       += o.victim_fills;
+    write_throughs     += o.write_throughs;
+    wbuf_coalesced     += o.wbuf_coalesced;
+    victim_probes      += o.victim_probes;
+    victim_hits        += o.victim_hits;
+    return *this;
+}
+
+const char* inclusion_name(Inclusion i) {
+    switch (i) {
+    case Inclusion::Inclusive: return "inclusive";
+    case Inclusion::Exclusive: return "exclusive";
+    case Inclusion::Nine:      break;
+    }
+    return "nine";
+}
+
+const char* write_policy_name(WritePolicy w) {
+    switch (w) {
+    case WritePolicy::WriteBackNoAllocate:    return "wbnwa";
+    case WritePolicy::WriteThroughAllocate:   return "wtwa";
+    case WritePolicy::WriteThroughNoAllocate: return "wtnwa";
+    case WritePolicy::WriteBackAllocate:      break;
+    }
+    return "wbwa";
+}
+
+bool parse_write_policy(const char* s, WritePolicy& out) {
+    if (strcmp(s, "wbwa") == 0)  { out = WritePolicy::WriteBackAllocate;      return true; }
+    if (strcmp(s, "wbnwa") == 0) { out = WritePolicy::WriteBackNoAllocate;    return true; }
+    if (strcmp(s, "wtwa") == 0)  { out = WritePolicy::WriteThroughAllocate;   return true; }
+    if (strcmp(s, "wtnwa") == 0) { out = WritePolicy::WriteThroughNoAllocate; return true; }
+    return false;
+}
+
+bool parse_inclusion(const char* s, Inclusion& out) {
+    if (strcmp(s, "nine") == 0)      { out = Inclusion::Nine;      return true; }
+    if (strcmp(s, "inclusive") == 0) { out = Inclusion::Inclusive; return true; }
+    if (strcmp(s, "exclusive") == 0) { out = Inclusion::Exclusive; return true; }
+    return false;
+}
+
+AddressMap AddressMap::make(std::size_t block_bytes, std::size_t sets) {
+    AddressMap m;
+    m.off_bits = ilog2_uint32(static_cast<uint32_t>(block_bytes));
+    m.idx_bits = ilog2_uint32(static_cast<uint32_t>(sets));
+    m.idx_mask = (m.idx_bits == 64 ? ~0ULL : ((1ULL << m.idx_bits) - 1ULL));
+    return m;
+}
 
 Cache::Cache(const CacheConfig& cfg) : cfg_(cfg) {
     compute_geometry_();
@@ -51,32 +118,70 @@ void Cache::compute_geometry_() {
     assert((cfg_.size_bytes % (cfg_.assoc * cfg_.block_bytes)) == 0);
 
     sets_     = cfg_.size_bytes / (cfg_.assoc * cfg_.block_bytes);
-    off_bits_ = ilog2_uint32(static_cast<uint32_t>(cfg_.block_bytes));
-    idx_bits_ = ilog2_uint32(static_cast<uint32_t>(sets_));
-    idx_mask_ = (idx_bits_ == 64 ? ~0ULL : ((1ULL << idx_bits_) - 1ULL));
+    const AddressMap map = AddressMap::make(cfg_.block_bytes, sets_);
+    off_bits_ = map.off_bits;
+    idx_bits_ = map.idx_bits;
+    idx_mask_ = map.idx_mask;
+    match_fn_ = tag_match_for_assoc(cfg_.assoc);
+    assert(cfg_.repl != ReplPolicy::Plru || (cfg_.assoc & (cfg_.assoc - 1)) == 0);
 }
 
+// Below this many ways a fully-associative set is cheaper to scan than to hash.
+static const std::size_t kFaIndexMinWays = 32;
+
 void Cache::init_storage_() {
-    sets_vec_.assign(sets_, std::vector<Line>(cfg_.assoc));
-    for (auto& set : sets_vec_) {
-        for (uint32_t w = 0; w < set.size(); ++w) {
-            set[w].lru_age = w; // larger -> older
-        }
+    const std::size_t lines = sets_ * cfg_.assoc;
+    tags_.assign(lines, 0);
+    state_.assign(lines, 0);
+    valid_count_.assign(sets_, 0);
+    free_hint_.assign(sets_, 0);
+    repl_.init(cfg_.repl, sets_, cfg_.assoc);
+    if (sets_ == 1 && cfg_.assoc >= kFaIndexMinWays) {
+        fa_index_ = std::make_unique<FullyAssocIndex>(cfg_.assoc);
+    } else {
+        fa_index_.reset();
     }
+#ifdef CACHE_LRU_AGE
+    lru_age_.resize(lines);
+    for (std::size_t i = 0; i < lines; ++i) {
+        lru_age_[i] = static_cast<uint32_t>(i % cfg_.assoc); // larger -> older
+    }
+#else
+    // Initial recency order is way 0 (MRU) .. way assoc-1 (LRU), matching
+    // the initial ages of the counter implementation.
+    const uint32_t assoc = static_cast<uint32_t>(cfg_.assoc);
+    lru_prev_.resize(lines);
+    lru_next_.resize(lines);
+    lru_head_.assign(sets_, 0);
+    lru_tail_.assign(sets_, assoc - 1);
+    for (std::size_t i = 0; i < lines; ++i) {
+        const uint32_t w = static_cast<uint32_t>(i % assoc);
+        lru_prev_[i] = w - 1;   // wraps to UINT32_MAX at the head (unused)
+        lru_next_[i] = w + 1;   // == assoc at the tail (unused)
+    }
+#endif
 }
 
 uint64_t Cache::index_of(uint32_t addr) const {
-    return (addr >> off_bits_) & idx_mask_;
+    return address_map().index_of(addr);
 }
 
 uint64_t Cache::tag_of(uint32_t addr) const {
-    return static_cast<uint64_t>(addr) >> (off_bits_ + idx_bits_);
+    return address_map().tag_of(addr);
 }
 
 int Cache::find_way(uint64_t set, uint64_t tag) const {
-    const auto& lines = sets_vec_[set];
-    for (int w = 0; w < static_cast<int>(lines.size()); ++w) {
-        if (lines[w].valid && lines[w].tag == tag) {
+    const uint32_t* tags  = &tags_[slot(set, 0)];
+    const uint8_t*  state = &state_[slot(set, 0)];
+    const int assoc = static_cast<int>(cfg_.assoc);
+    if (fa_index_) {
+        return fa_index_->find(static_cast<uint32_t>(tag));
+    }
+    if (match_fn_) {
+        return match_fn_(tags, state, assoc, static_cast<uint32_t>(tag), kValid);
+    }
+    for (int w = 0; w < assoc; ++w) {
+        if (tags[w] == tag && (state[w] & kValid)) {
             return w;
         }
     }
@@ -84,69 +189,328 @@ int Cache::find_way(uint64_t set, uint64_t tag) const {
 }
 
 int Cache::choose_victim_way(uint64_t set) {
-    const auto& lines = sets_vec_[set];
+    const uint8_t*  state = &state_[slot(set, 0)];
+#ifndef CACHE_LRU_AGE
+    if (valid_count_[set] == cfg_.assoc) {
+        return static_cast<int>(lru_tail_[set]);
+    }
+    // Free slot preferred; the hint makes filling a huge set amortized O(1).
+    uint32_t& hint = free_hint_[set];
+    while (hint < cfg_.assoc && (state[hint] & kValid)) ++hint;
+    if (hint < cfg_.assoc) return static_cast<int>(hint);
+    return static_cast<int>(lru_tail_[set]);
+#else
+    const uint32_t* age   = &lru_age_[slot(set, 0)];
+    const int assoc = static_cast<int>(cfg_.assoc);
     int victim = 0;
     uint32_t max_age = 0;
-    for (int w = 0; w < static_cast<int>(lines.size()); ++w) {
-        if (!lines[w].valid) return w; // free slot preferred
-        if (lines[w].lru_age >= max_age) {
-            max_age = lines[w].lru_age;
+    for (int w = 0; w < assoc; ++w) {
+        if (!(state[w] & kValid)) return w; // free slot preferred
+        if (age[w] >= max_age) {
+            max_age = age[w];
             victim = w;
         }
     }
     return victim;
+#endif
 }
 
 void Cache::touch_as_mru(uint64_t set, int way) {
-    // Placeholder LRU update: bump all valid ages; selected line becomes MRU (0).
-    auto& lines = sets_vec_[set];
-    for (auto& ln : lines) { if (ln.valid) ++ln.lru_age; }
-    lines[way].lru_age = 0;
+#ifndef CACHE_LRU_AGE
+    lru_promote_(set, static_cast<uint32_t>(way));
+#else
+    // Reference LRU update: bump all valid ages; selected line becomes MRU (0).
+    const uint8_t* state = &state_[slot(set, 0)];
+    uint32_t*      age   = &lru_age_[slot(set, 0)];
+    const int assoc = static_cast<int>(cfg_.assoc);
+    for (int w = 0; w < assoc; ++w) { if (state[w] & kValid) ++age[w]; }
+    age[way] = 0;
+#endif
 }
 
 void Cache::fill_line(uint64_t set, int way, uint64_t tag, bool dirty) {
-    auto& ln = sets_vec_[set][way];
-    ln.valid = true;
-    ln.dirty = dirty;
-    ln.tag   = tag;
-    touch_as_mru(set, way);
+    const std::size_t i = slot(set, way);
+    if (fa_index_) {
+        if (state_[i] & kValid) fa_index_->erase(tags_[i]);
+        fa_index_->insert(static_cast<uint32_t>(tag), static_cast<uint32_t>(way));
+    }
+    if (!(state_[i] & kValid)) valid_count_[set] += 1;
+    state_[i] = static_cast<uint8_t>(kValid | (dirty ? kDirty : 0));
+    tags_[i]  = static_cast<uint32_t>(tag);
+}
+
+// ---- Replacement hooks: LRU uses the recency list, others replacement.h ----
+
+template <class Policy>
+inline void Cache::repl_hit_(uint64_t set, uint32_t way) { Policy::on_hit(repl_, set, way); }
+
+template <class Policy>
+inline void Cache::repl_fill_(uint64_t set, uint32_t way) { Policy::on_fill(repl_, set, way); }
+
+template <class Policy>
+inline uint32_t Cache::repl_victim_(uint64_t set) {
+    if (valid_count_[set] < cfg_.assoc) {
+        // Free slot preferred (same hint scheme as the LRU path).
+        const uint8_t* state = &state_[slot(set, 0)];
+        uint32_t& hint = free_hint_[set];
+        while (hint < cfg_.assoc && (state[hint] & kValid)) ++hint;
+        if (hint < cfg_.assoc) return hint;
+    }
+    return Policy::victim(repl_, set);
 }
 
+template <>
+inline void Cache::repl_hit_<LruRepl>(uint64_t set, uint32_t way) { touch_as_mru(set, static_cast<int>(way)); }
+
+template <>
+inline void Cache::repl_fill_<LruRepl>(uint64_t set, uint32_t way) { touch_as_mru(set, static_cast<int>(way)); }
+
+template <>
+inline uint32_t Cache::repl_victim_<LruRepl>(uint64_t set) { return static_cast<uint32_t>(choose_victim_way(set)); }
+
 void Cache::writeback_down(uint32_t victim_block_addr, Cache* next_level) {
-    if (next_level) {
-        next_level->access(Op::Write, victim_block_addr, nullptr);
+    send_write_down_(victim_block_addr, next_level);
+    stats_.writebacks += 1;
+}
+
+void Cache::write_down_now_(uint32_t block_addr, Cache* next_level) {
+    if (miss_queue_) {
+        miss_queue_->push(encode_miss_event(Op::Write, block_addr));
+    } else if (next_level) {
+        next_level->access(Op::Write, block_addr, next_level->next_level_);
     } else {
         stats_.memory_writes += 1;
     }
-    stats_.writebacks += 1;
 }
 
-void Cache::allocate_on_miss(uint32_t addr, Cache* next_level, bool make_dirty) {
+void Cache::send_write_down_(uint32_t block_addr, Cache* next_level) {
+    if (!write_buffer_) {
+        write_down_now_(block_addr, next_level);
+    } else if (write_buffer_->contains(block_addr)) {
+        stats_.wbuf_coalesced += 1;
+    } else {
+        if (write_buffer_->full()) write_down_now_(write_buffer_->pop_oldest(), next_level);
+        write_buffer_->push(block_addr);
+    }
+}
+
+void Cache::attach_write_buffer(uint32_t entries) {
+    if (entries > 0) write_buffer_ = std::make_unique<WriteBuffer>(entries);
+    else             write_buffer_.reset();
+}
+
+void Cache::drain_write_buffer() {
+    while (write_buffer_ && !write_buffer_->empty()) {
+        write_down_now_(write_buffer_->pop_oldest(), next_level_);
+    }
+}
+
+void Cache::attach_victim_cache(uint32_t entries) {
+    if (entries > 0) victim_cache_ = std::make_unique<VictimCache>(entries);
+    else             victim_cache_.reset();
+}
+
+void Cache::attach_prefetcher(uint32_t buffers, uint32_t blocks_per_buffer) {
+    if (buffers > 0 && blocks_per_buffer > 0) {
+        prefetcher_ = std::make_unique<StreamPrefetcher>(buffers, blocks_per_buffer);
+    } else {
+        prefetcher_.reset();
+    }
+}
+
+template <class Policy>
+void Cache::allocate_with_(uint32_t addr, Cache* next_level, bool make_dirty, bool fetch) {
     const uint64_t set = index_of(addr);
     const uint64_t tag = tag_of(addr);
-    int victim = choose_victim_way(set);
-
-    if (sets_vec_[set][victim].valid) {
-        if (sets_vec_[set][victim].dirty) {
-            uint32_t victim_block_addr =
-                static_cast<uint32_t>(
-                    (sets_vec_[set][victim].tag << (idx_bits_ + off_bits_)) |
-                    (static_cast<uint32_t>(set) << off_bits_)
-                );
-            writeback_down(victim_block_addr, next_level);
+    const bool exclusive_below = next_level && next_level->cfg_.inclusion == Inclusion::Exclusive;
+    service_depth_ = 0;
+
+    // A victim-cache hit swaps the block back in: its slot there takes our
+    // victim below, and nothing is fetched.
+    if (fetch && victim_cache_) {
+        stats_.victim_probes += 1;
+        bool was_dirty = false;
+        if (victim_cache_->take(block_aligned(addr), was_dirty)) {
+            stats_.victim_hits += 1;
+            make_dirty = make_dirty || was_dirty;
+            fetch = false;
+        }
+    }
+
+    // An exclusive level gives up its copy before it receives our victim,
+    // so the victim fill cannot displace the block being fetched.
+    if (fetch) drain_pending_write_(block_aligned(addr), next_level);
+    if (fetch && exclusive_below && !miss_queue_) {
+        if (next_level->take_block_(block_aligned(addr))) make_dirty = true;
+        service_depth_ = 1 + next_level->service_depth_;
+        fetch = false;
+    }
+
+    const int victim = static_cast<int>(repl_victim_<Policy>(set));
+
+    const std::size_t vi = slot(set, victim);
+    if (state_[vi] & kValid) {
+        uint32_t victim_block_addr =
+            static_cast<uint32_t>(
+                (static_cast<uint64_t>(tags_[vi]) << (idx_bits_ + off_bits_)) |
+                (static_cast<uint32_t>(set) << off_bits_)
+            );
+        bool dirty = (state_[vi] & kDirty) != 0;
+        // With a victim cache the line only leaves this level when it falls
+        // out of the victim cache's LRU end.
+        const bool leaves = !victim_cache_ ||
+                            victim_cache_->insert(victim_block_addr, dirty, victim_block_addr, dirty);
+        if (leaves) {
+            if (cfg_.inclusion == Inclusion::Inclusive && back_invalidate_(victim_block_addr)) dirty = true;
+            if (exclusive_below && !miss_queue_) {
+                if (dirty) stats_.writebacks += 1;
+                next_level->victim_fill_(victim_block_addr, dirty);
+            } else if (dirty) {
+                writeback_down(victim_block_addr, next_level);
+            }
         }
     }
 
-    if (next_level) {
-        next_level->access(Op::Read, block_aligned(addr), nullptr);
+    if (!fetch) {
+        // Supplied by a stream buffer, the victim cache or an exclusive
+        // level; no further traffic.
+    } else if (miss_queue_) {
+        miss_queue_->push(encode_miss_event(Op::Read, block_aligned(addr)));
+        service_depth_ = 1;   // unknown: the level below runs on another thread
+    } else if (next_level) {
+        const bool hit_below = next_level->access(Op::Read, block_aligned(addr), next_level->next_level_);
+        service_depth_ = hit_below ? 1 : 1 + next_level->service_depth_;
     } else {
         stats_.memory_reads += 1;
+        service_depth_ = 1;
     }
 
     fill_line(set, victim, tag, make_dirty);
+    repl_fill_<Policy>(set, static_cast<uint32_t>(victim));
+}
+
+bool Cache::invalidate_block_(uint32_t block_addr, bool& was_dirty) {
+    const uint64_t set = index_of(block_addr);
+    const int way = find_way(set, tag_of(block_addr));
+    if (way < 0) return victim_cache_ && victim_cache_->take(block_addr, was_dirty);
+
+    const std::size_t i = slot(set, way);
+    was_dirty = (state_[i] & kDirty) != 0;
+    if (fa_index_) fa_index_->erase(tags_[i]);
+    state_[i] = 0;
+    valid_count_[set] -= 1;
+    if (static_cast<uint32_t>(way) < free_hint_[set]) free_hint_[set] = static_cast<uint32_t>(way);
+    return true;
+}
+
+bool Cache::back_invalidate_(uint32_t block_addr) {
+    bool dirty = false;
+    for (Cache* up = upper_level_; up; up = up->upper_level_) {
+        bool d = false;
+        if (up->invalidate_block_(block_addr, d)) {
+            stats_.back_invalidations += 1;
+            dirty = dirty || d;
+        }
+    }
+    return dirty;
+}
+
+bool Cache::take_block_(uint32_t addr) {
+    const uint64_t set = index_of(addr);
+    const int way = find_way(set, tag_of(addr));
+    stats_.reads += 1;
+
+    bool sb_hit = false;
+    if (prefetcher_) {
+        uint64_t issued = 0;
+        sb_hit = prefetcher_->access(addr >> off_bits_, way >= 0, issued);
+        stats_.pref_issued += issued;
+    }
+    if (classifier_) classifier_->access(addr >> off_bits_, way < 0 && !sb_hit);
+    if (reuse_)      reuse_->access(addr >> off_bits_);
+
+    service_depth_ = 0;
+    if (way >= 0) {
+        bool dirty = false;
+        invalidate_block_(addr, dirty);
+        return dirty;
+    }
+    if (sb_hit) {
+        stats_.pref_useful += 1;
+        return false;
+    }
+
+    stats_.read_misses += 1;
+    if (victim_cache_) {
+        stats_.victim_probes += 1;
+        bool was_dirty = false;
+        if (victim_cache_->take(addr, was_dirty)) {
+            stats_.victim_hits += 1;
+            return was_dirty;
+        }
+    }
+    drain_pending_write_(addr, next_level_);
+    if (next_level_ && next_level_->cfg_.inclusion == Inclusion::Exclusive) {
+        const bool dirty = next_level_->take_block_(addr);
+        service_depth_ = 1 + next_level_->service_depth_;
+        return dirty;
+    }
+    if (next_level_) {
+        const bool hit_below = next_level_->access(Op::Read, addr, next_level_->next_level_);
+        service_depth_ = hit_below ? 1 : 1 + next_level_->service_depth_;
+    } else {
+        stats_.memory_reads += 1;
+        service_depth_ = 1;
+    }
+    return false;
+}
+
+void Cache::victim_fill_(uint32_t block_addr, bool dirty) {
+    stats_.victim_fills += 1;
+    const uint64_t set = index_of(block_addr);
+    const int way = find_way(set, tag_of(block_addr));
+    if (way >= 0) {
+        // Only if the level above also filled from elsewhere; keep one copy.
+        if (dirty) state_[slot(set, way)] |= kDirty;
+        return;
+    }
+    switch (cfg_.repl) {
+    case ReplPolicy::Plru:  allocate_with_<PlruRepl>(block_addr, next_level_, dirty, false);  return;
+    case ReplPolicy::Nru:   allocate_with_<NruRepl>(block_addr, next_level_, dirty, false);   return;
+    case ReplPolicy::Srrip: allocate_with_<SrripRepl>(block_addr, next_level_, dirty, false); return;
+    case ReplPolicy::Brrip: allocate_with_<BrripRepl>(block_addr, next_level_, dirty, false); return;
+    case ReplPolicy::Drrip: allocate_with_<DrripRepl>(block_addr, next_level_, dirty, false); return;
+    case ReplPolicy::Lru:   break;
+    }
+    allocate_with_<LruRepl>(block_addr, next_level_, dirty, false);
+}
+
+void Cache::enable_miss_classification() {
+    classifier_ = std::make_unique<MissClassifier>(sets_ * cfg_.assoc);
+}
+
+void Cache::enable_reuse_histogram() {
+    reuse_ = std::make_unique<ReuseHistogram>();
+}
+
+void Cache::allocate_on_miss(uint32_t addr, Cache* next_level, bool make_dirty, bool fetch) {
+    allocate_with_<LruRepl>(addr, next_level, make_dirty, fetch);
 }
 
 bool Cache::access(Op op, uint32_t addr, Cache* next_level) {
+    switch (cfg_.repl) {
+    case ReplPolicy::Plru:  return access_with_<PlruRepl>(op, addr, next_level);
+    case ReplPolicy::Nru:   return access_with_<NruRepl>(op, addr, next_level);
+    case ReplPolicy::Srrip: return access_with_<SrripRepl>(op, addr, next_level);
+    case ReplPolicy::Brrip: return access_with_<BrripRepl>(op, addr, next_level);
+    case ReplPolicy::Drrip: return access_with_<DrripRepl>(op, addr, next_level);
+    case ReplPolicy::Lru:   break;
+    }
+    return access_with_<LruRepl>(op, addr, next_level);
+}
+
+template <class Policy>
+bool Cache::access_with_(Op op, uint32_t addr, Cache* next_level) {
     const uint64_t set = index_of(addr);
     const uint64_t tag = tag_of(addr);
 
@@ -154,44 +518,145 @@ bool Cache::access(Op op, uint32_t addr, Cache* next_level) {
     else                stats_.writes += 1;
 
     int way = find_way(set, tag);
+    // A no-allocate write miss never fills this level, so it is a miss
+    // whatever the stream buffers hold and must not consume their entries.
+    const bool goes_around = way < 0 && op == Op::Write && !write_allocate_();
+
+    // Stream buffers see every demand access (hit or miss) to this level
+    // that could be filled from them.
+    bool sb_hit = false;
+    if (prefetcher_ && !goes_around) {
+        uint64_t issued = 0;
+        sb_hit = prefetcher_->access(addr >> off_bits_, way >= 0, issued);
+        stats_.pref_issued += issued;
+    }
+    if (classifier_) classifier_->access(addr >> off_bits_, way < 0 && !sb_hit);
+    if (reuse_)      reuse_->access(addr >> off_bits_);
+
     if (way >= 0) {
         if (op == Op::Write) {
-            sets_vec_[set][way].dirty = true; // WBWA: write hits mark dirty
+            if (write_through_()) {
+                stats_.write_throughs += 1;
+                send_write_down_(block_aligned(addr), next_level);
+            } else {
+                state_[slot(set, way)] |= kDirty; // write-back: write hits mark dirty
+            }
         }
-        touch_as_mru(set, way);
+        repl_hit_<Policy>(set, static_cast<uint32_t>(way));
         return true;
     }
 
-    // Miss
-    if (op == Op::Read) stats_.read_misses += 1;
-    else                stats_.write_misses += 1;
+    if (goes_around) {
+        // No-allocate write miss: the write goes around this level (and
+        // its victim cache) without waiting for it. A copy parked in the
+        // victim cache would go stale, so it leaves now, written back first
+        // if dirty.
+        stats_.write_misses += 1;
+        service_depth_ = 0;
+        bool vc_dirty = false;
+        if (victim_cache_ && victim_cache_->take(block_aligned(addr), vc_dirty) && vc_dirty) {
+            writeback_down(block_aligned(addr), next_level);
+        }
+        stats_.write_throughs += 1;
+        send_write_down_(block_aligned(addr), next_level);
+        return false;
+    }
 
-    // WBWA + write-allocate: allocate on both read and write misses.
-    const bool make_dirty = (op == Op::Write);
-    allocate_on_miss(addr, next_level, make_dirty);
-    return false;
+    // Write-allocate: allocate on both read and write misses; write-through
+    // lines stay clean and the write follows the fill down.
+    const bool make_dirty = (op == Op::Write) && !write_through_();
+
+    if (sb_hit) {
+        // Cache miss served by a stream buffer: not a miss, no fetch.
+        stats_.pref_useful += 1;
+        allocate_with_<Policy>(addr, next_level, make_dirty, /*fetch=*/false);
+    } else {
+        if (op == Op::Read) stats_.read_misses += 1;
+        else                stats_.write_misses += 1;
+        allocate_with_<Policy>(addr, next_level, make_dirty, /*fetch=*/true);
+    }
+
+    if (op == Op::Write && write_through_()) {
+        stats_.write_throughs += 1;
+        send_write_down_(block_aligned(addr), next_level);
+    }
+    return sb_hit;
+}
+
+void Cache::merge_sets_from(const Cache& shard, std::size_t set_begin, std::size_t set_end) {
+    assert(shard.cfg_.size_bytes == cfg_.size_bytes && shard.cfg_.assoc == cfg_.assoc &&
+           shard.cfg_.block_bytes == cfg_.block_bytes && shard.cfg_.repl == cfg_.repl);
+    assert(set_begin <= set_end && set_end <= sets_);
+    assert(!fa_index_ || (set_begin == 0 && set_end == sets_));
+    assert(repl_is_per_set(cfg_.repl));
+
+    const std::size_t lo = slot(set_begin, 0);
+    const std::size_t hi = slot(set_end, 0);
+    std::copy(shard.tags_.begin()  + lo, shard.tags_.begin()  + hi, tags_.begin()  + lo);
+    std::copy(shard.state_.begin() + lo, shard.state_.begin() + hi, state_.begin() + lo);
+#ifdef CACHE_LRU_AGE
+    std::copy(shard.lru_age_.begin() + lo, shard.lru_age_.begin() + hi, lru_age_.begin() + lo);
+#else
+    std::copy(shard.lru_prev_.begin() + lo, shard.lru_prev_.begin() + hi, lru_prev_.begin() + lo);
+    std::copy(shard.lru_next_.begin() + lo, shard.lru_next_.begin() + hi, lru_next_.begin() + lo);
+    std::copy(shard.lru_head_.begin() + set_begin, shard.lru_head_.begin() + set_end, lru_head_.begin() + set_begin);
+    std::copy(shard.lru_tail_.begin() + set_begin, shard.lru_tail_.begin() + set_end, lru_tail_.begin() + set_begin);
+#endif
+    if (!repl_.meta.empty()) {
+        std::copy(shard.repl_.meta.begin() + lo, shard.repl_.meta.begin() + hi, repl_.meta.begin() + lo);
+    }
+    std::copy(shard.valid_count_.begin() + set_begin, shard.valid_count_.begin() + set_end,
+              valid_count_.begin() + set_begin);
+    std::copy(shard.free_hint_.begin() + set_begin, shard.free_hint_.begin() + set_end,
+              free_hint_.begin() + set_begin);
+    if (fa_index_) fa_index_ = std::make_unique<FullyAssocIndex>(*shard.fa_index_);
+
+    stats_ += shard.stats_;
 }
 
 void Cache::print_contents(std::ostream& os) const {
     for (std::size_t s = 0; s < sets_; ++s) {
-        // Gather valid lines
-        std::vector<Line> lines;
+        // Gather valid ways, ordered MRU -> LRU
+        std::vector<std::size_t> lines;
         lines.reserve(cfg_.assoc);
-        for (const auto& ln : sets_vec_[s]) {
-            if (ln.valid) lines.push_back(ln);
-        }
-        if (lines.empty()) continue;
+        if (cfg_.repl != ReplPolicy::Lru) {
+            // No recency list: most protected first by the policy's rank
+            // (e.g. RRPV), ties in way order.
+            for (std::size_t w = 0; w < cfg_.assoc; ++w) {
+                const std::size_t i = slot(s, static_cast<int>(w));
+                if (state_[i] & kValid) lines.push_back(i);
+            }
+            if (lines.empty()) continue;
+            std::stable_sort(lines.begin(), lines.end(), [this, s](std::size_t a, std::size_t b) {
+                return repl_.rank(cfg_.repl, s, static_cast<uint32_t>(a - slot(s, 0))) <
+                       repl_.rank(cfg_.repl, s, static_cast<uint32_t>(b - slot(s, 0)));
+            });
+        } else {
+#ifndef CACHE_LRU_AGE
+            for (uint32_t w = lru_head_[s], k = 0; k < cfg_.assoc; w = lru_next_[slot(s, static_cast<int>(w))], ++k) {
+                const std::size_t i = slot(s, static_cast<int>(w));
+                if (state_[i] & kValid) lines.push_back(i);
+            }
+            if (lines.empty()) continue;
+#else
+            for (std::size_t w = 0; w < cfg_.assoc; ++w) {
+                const std::size_t i = slot(s, static_cast<int>(w));
+                if (state_[i] & kValid) lines.push_back(i);
+            }
+            if (lines.empty()) continue;
 
-        // Order MRU -> LRU (lru_age: 0 = MRU)
-        std::sort(lines.begin(), lines.end(),
-                  [](const Line& a, const Line& b){ return a.lru_age < b.lru_age; });
+            // lru_age: 0 = MRU
+            std::sort(lines.begin(), lines.end(),
+                      [this](std::size_t a, std::size_t b){ return lru_age_[a] < lru_age_[b]; });
+#endif
+        }
 
         // Exact expected format:  set______N:␠␠<tag> [D] ...
         os << "set " << std::setw(6) << s << ":   ";
         bool first = true;
-        for (const auto& ln : lines) {
+        for (std::size_t i : lines) {
             if (!first) os << " ";
-            os << std::hex << ln.tag << (ln.dirty ? " D" : "");
+            os << std::hex << tags_[i] << ((state_[i] & kDirty) ? " D" : "");
             first = false;
         }
         os << std::dec << "\n";
@@ -6,15 +6,67 @@
 #include <vector>
 #include <string>
 #include <ostream>
+#include <memory>
+
+#include "tag_match.h"
+#include "fa_index.h"
+#include "spsc_ring.h"
+#include "prefetch.h"
+#include "replacement.h"
+#include "miss_class.h"
+#include "reuse_dist.h"
+#include "write_buffer.h"
+#include "victim_cache.h"
 
 // ECE463: Implement a generic set-associative cache with LRU and WBWA.
 // Use this same class for L1 and L2 by passing different params.
+// LRU is an O(1) linked recency list by default; build with -DCACHE_LRU_AGE
+// for the original age-counter implementation. Other replacement policies
+// (PLRU, NRU, SRRIP/BRRIP/DRRIP) are selected per cache via CacheConfig::repl.
+
+// How a level relates to the contents of the levels above it (a property of
+// the lower level of each pair; meaningless for L1):
+//   Nine      - non-inclusive, non-exclusive: misses fill every level on the
+//               way up and evictions never look upwards (the default).
+//   Inclusive - every block above is also here: evicting a block
+//               back-invalidates it in all levels above, and a dirty upper
+//               copy is written back along with it.
+//   Exclusive - holds only blocks the level above does not: a hit hands the
+//               block up and drops it here, a miss fetches from below without
+//               allocating here, and the level above victim-fills this level
+//               with every line it evicts, clean or dirty.
+enum class Inclusion { Nine, Inclusive, Exclusive };
+
+const char* inclusion_name(Inclusion i);
+
+// Parse "nine", "inclusive" or "exclusive".
+bool parse_inclusion(const char* s, Inclusion& out);
+
+// What a level does with writes (demand writes, and writebacks arriving
+// from the level above):
+//   WriteBackAllocate      - WBWA: write misses allocate, lines turn dirty
+//                            and are written back on eviction (the default).
+//   WriteBackNoAllocate    - write hits as WBWA; write misses go to the level
+//                            below without allocating here.
+//   WriteThroughAllocate   - every write also goes to the level below; write
+//                            misses allocate. Lines are never dirty.
+//   WriteThroughNoAllocate - every write goes to the level below; write
+//                            misses do not allocate.
+enum class WritePolicy { WriteBackAllocate, WriteBackNoAllocate, WriteThroughAllocate, WriteThroughNoAllocate };
+
+const char* write_policy_name(WritePolicy w);
+
+// Parse "wbwa", "wbnwa", "wtwa" or "wtnwa".
+bool parse_write_policy(const char* s, WritePolicy& out);
 
 struct CacheConfig {
     std::string name;           // "L1" or "L2" for printing
     std::size_t size_bytes;     // total capacity
     std::size_t assoc;          // ways
     std::size_t block_bytes;    // line size
+    ReplPolicy  repl = ReplPolicy::Lru; // see replacement.h
+    Inclusion   inclusion = Inclusion::Nine; // towards the level above
+    WritePolicy write = WritePolicy::WriteBackAllocate;
 };
 
 struct AccessStats {
@@ -28,12 +80,43 @@ struct AccessStats {
     uint64_t memory_reads;      // demand fills that go to "memory"
     uint64_t memory_writes;     // writebacks that reach "memory"
 
-    // For ECE463, prefetch counters should remain zero.
-    uint64_t pref_issued;
-    uint64_t pref_useful;
-    uint64_t pref_late;
+    // Stream-buffer prefetcher (last level only; zero when disabled).
+    uint64_t pref_issued;       // prefetches sent to memory
+    uint64_t pref_useful;       // demand misses served by a stream buffer
+    uint64_t pref_late;         // always 0: the model has no timing
+
+    // Inclusion policies (zero under NINE).
+    uint64_t back_invalidations; // inclusive: upper-level lines invalidated by our evictions
+    uint64_t victim_fills;       // exclusive: lines received from the level above on eviction
+
+    // Write policies and write buffer (zero under WBWA without a buffer).
+    uint64_t write_throughs;     // writes passed down (write-through, or no-allocate write misses)
+    uint64_t wbuf_coalesced;     // writes merged into a pending write-buffer entry
+
+    // Victim cache (zero without one).
+    uint64_t victim_probes;      // misses that looked in the victim cache
+    uint64_t victim_hits;        // ...and found their block there (no fetch below)
 
     AccessStats();
+
+    // Field-wise sum (merging shard results).
+    AccessStats& operator+=(const AccessStats& o);
+};
+
+// Address decomposition for a (block size, set count) geometry: the same
+// index/tag split Cache uses internally, available to analysis passes that
+// never build a Cache.
+struct AddressMap {
+    uint32_t off_bits = 0;   // log2(block_bytes)
+    uint32_t idx_bits = 0;   // log2(sets)
+    uint64_t idx_mask = 0;   // mask for index
+
+    // Preconditions: both arguments are powers of two.
+    static AddressMap make(std::size_t block_bytes, std::size_t sets);
+
+    uint32_t block_of(uint32_t addr) const { return addr >> off_bits; }
+    uint64_t index_of(uint32_t addr) const { return (addr >> off_bits) & idx_mask; }
+    uint64_t tag_of(uint32_t addr)   const { return static_cast<uint64_t>(addr) >> (off_bits + idx_bits); }
 };
 
 class Cache {
@@ -43,7 +126,8 @@ public:
     Cache(const CacheConfig& cfg);
 
     // Top-level API: access 'addr'. If next_level != nullptr, forward misses to it.
-    // Return true on hit in THIS level; false if miss (even if served by lower level).
+    // Return true on hit in THIS level (cache or its stream buffers); false if
+    // miss (even if served by lower level).
     bool access(Op op, uint32_t addr, Cache* next_level);
 
     // Print per-set contents in MRU->LRU order as your spec requires.
@@ -52,19 +136,91 @@ public:
     // Expose stats for final report.
     const AccessStats& stats() const { return stats_; }
     const CacheConfig& config() const { return cfg_; }
+    AddressMap address_map() const { return AddressMap{ off_bits_, idx_bits_, idx_mask_ }; }
 
     // Clear/initialize all state (optional utility when testing).
     void reset();
 
+    // Lower-level traffic as (op, block address) events, for pipelined
+    // simulation (see pipeline.h). While a queue is set, misses and
+    // writebacks are pushed to it instead of going to next_level/memory.
+    typedef SpscRing<uint64_t> MissQueue;
+    void set_miss_queue(MissQueue* q) { miss_queue_ = q; }
+    static uint64_t encode_miss_event(Op op, uint32_t addr) {
+        return (static_cast<uint64_t>(addr) << 1) | (op == Op::Write ? 1u : 0u);
+    }
+    static void decode_miss_event(uint64_t ev, Op& op, uint32_t& addr) {
+        op   = (ev & 1) ? Op::Write : Op::Read;
+        addr = static_cast<uint32_t>(ev >> 1);
+    }
+
+    // Attach a stream-buffer prefetcher (PREF_N buffers of PREF_M blocks).
+    // Only the last-level cache should have one; its prefetches go to memory.
+    void attach_prefetcher(uint32_t buffers, uint32_t blocks_per_buffer);
+    const StreamPrefetcher* prefetcher() const { return prefetcher_.get(); }
+
+    // Put a coalescing write buffer of 'entries' blocks (0 = none) between
+    // this cache and the level below; write-throughs and writebacks queue
+    // there. drain_write_buffer() sends what is still pending at the end of
+    // a run.
+    void attach_write_buffer(uint32_t entries);
+    const WriteBuffer* write_buffer() const { return write_buffer_.get(); }
+    void drain_write_buffer();
+
+    // Put a fully-associative victim cache of 'entries' lines (0 = none)
+    // behind this cache (see victim_cache.h): evicted lines go there, and a
+    // miss that hits it swaps the line back without going to the level below.
+    void attach_victim_cache(uint32_t entries);
+    const VictimCache* victim_cache() const { return victim_cache_.get(); }
+
+    // Classify this level's misses as compulsory / capacity / conflict
+    // (see miss_class.h). Off by default; costs a shadow cache per level.
+    void enable_miss_classification();
+    const MissClassifier* miss_classifier() const { return classifier_.get(); }
+
+    // Reuse-distance histogram of the block stream reaching this level
+    // (see reuse_dist.h). Off by default.
+    void enable_reuse_histogram();
+    const ReuseHistogram* reuse_histogram() const { return reuse_.get(); }
+
+    // Level below this one, used when this cache is itself reached as some
+    // other level's next_level (hierarchies deeper than two levels, see
+    // hierarchy.h). nullptr (the default) means memory. Also makes this cache
+    // the level above 'next', for inclusive back-invalidation.
+    void set_next_level(Cache* next) {
+        next_level_ = next;
+        if (next) next->upper_level_ = this;
+    }
+    Cache* next_level() const { return next_level_; }
+
+    // After a miss (access() returned false): how many levels below this one
+    // the block came from - 0 if this level supplied it anyway (victim
+    // cache, or a no-allocate write that did not wait), 1 for the next level,
+    // and so on, memory counting as one level past the last cache. Read by
+    // the timing model (timing.h); undefined after a hit.
+    uint32_t last_service_depth() const { return service_depth_; }
+
+    // Number of indexable sets.
+    std::size_t num_sets() const { return sets_; }
+
+    // Take over sets [set_begin, set_end) - tags, state and LRU order - from
+    // 'shard', a cache of identical geometry that simulated exactly the
+    // accesses mapping to those sets, and add its stats to ours.
+    void merge_sets_from(const Cache& shard, std::size_t set_begin, std::size_t set_end);
+
+    // Specialized hot path for a geometry fixed at compile time (constant
+    // shifts, fully unrolled way loop); behaves exactly like access().
+    // Only valid when has_fixed_kernel<BlockBytes, Assoc>() is true.
+    // Defined in cache_fixed.h.
+    template <uint32_t BlockBytes, uint32_t Assoc>
+    bool access_fixed(Op op, uint32_t addr, Cache* next_level);
+
+    template <uint32_t BlockBytes, uint32_t Assoc>
+    bool has_fixed_kernel() const;
+
 private:
-    struct Line {
-        bool     valid = false;
-        bool     dirty = false;
-        uint64_t tag   = 0;
-        // Implement LRU however you like (counter, age, stack position).
-        // Here we store an integer "age" where smaller == more recent, for example.
-        uint32_t lru_age = 0;
-    };
+    // Per-line state bits (state_ array)
+    enum : uint8_t { kValid = 1u << 0, kDirty = 1u << 1 };
 
     CacheConfig cfg_;
     AccessStats stats_;
@@ -75,8 +231,49 @@ private:
     uint32_t    idx_bits_    = 0; // log2(sets)
     uint64_t    idx_mask_    = 0; // mask for index
 
-    // sets_[set_index][way]
-    std::vector<std::vector<Line>> sets_vec_;
+    // Flat structure-of-arrays tag store: line (set, way) lives at slot
+    // set * assoc + way in each array, so one set's tags are contiguous.
+    // Addresses are 32-bit, so tags always fit in 32 bits.
+    std::vector<uint32_t> tags_;
+    std::vector<uint8_t>  state_;    // kValid | kDirty
+#ifdef CACHE_LRU_AGE
+    // Reference LRU: per-line age counter, O(assoc) update and victim scan.
+    std::vector<uint32_t> lru_age_;  // 0 == MRU, larger == older
+#else
+    // O(1) LRU: per-set doubly-linked recency list threaded through way
+    // indices (prev/next per line, MRU head and LRU tail per set).
+    std::vector<uint32_t> lru_prev_;
+    std::vector<uint32_t> lru_next_;
+    std::vector<uint32_t> lru_head_;   // MRU way of each set
+    std::vector<uint32_t> lru_tail_;   // LRU way of each set
+#endif
+    std::vector<uint32_t> valid_count_; // valid lines per set
+    std::vector<uint32_t> free_hint_;   // no invalid way below this index
+
+    // Vector tag-match kernel for high associativity (nullptr -> scalar loop).
+    TagMatchFn match_fn_ = nullptr;
+
+    // Metadata for non-LRU replacement policies (empty for LRU).
+    ReplState repl_;
+
+    // Fully-associative geometry (one set, many ways): hash index from tag to
+    // way, kept in sync by fill_line. nullptr for set-associative caches.
+    std::unique_ptr<FullyAssocIndex> fa_index_;
+
+    MissQueue* miss_queue_ = nullptr;
+    Cache*     next_level_  = nullptr;  // see set_next_level()
+    Cache*     upper_level_ = nullptr;  // the cache whose next level we are
+    uint32_t   service_depth_ = 0;      // see last_service_depth()
+
+    std::unique_ptr<StreamPrefetcher> prefetcher_;
+    std::unique_ptr<MissClassifier>   classifier_;
+    std::unique_ptr<ReuseHistogram>   reuse_;
+    std::unique_ptr<WriteBuffer>      write_buffer_;
+    std::unique_ptr<VictimCache>      victim_cache_;
+
+    std::size_t slot(uint64_t set, int way) const {
+        return static_cast<std::size_t>(set) * cfg_.assoc + static_cast<std::size_t>(way);
+    }
 
 private:
     // ---- Address helpers ----
@@ -90,14 +287,59 @@ private:
     int  choose_victim_way(uint64_t set);                // LRU selection
 
     void touch_as_mru(uint64_t set, int way);            // update LRU metadata
-    void fill_line(uint64_t set, int way, uint64_t tag, bool dirty);
+#ifndef CACHE_LRU_AGE
+    inline void lru_promote_(uint64_t set, uint32_t way); // O(1) list splice (cache_fixed.h)
+#endif
+    void fill_line(uint64_t set, int way, uint64_t tag, bool dirty); // no replacement update
 
     // Miss path: allocate, handle eviction (writeback if dirty), and interact with next level.
-    void allocate_on_miss(uint32_t addr, Cache* next_level, bool make_dirty);
+    // With fetch == false the block comes from a stream buffer instead.
+    // allocate_on_miss is the LRU instance of allocate_with_.
+    void allocate_on_miss(uint32_t addr, Cache* next_level, bool make_dirty, bool fetch = true);
+
+    // Access/miss paths instantiated per replacement policy (replacement.h);
+    // access() picks the instance for cfg_.repl.
+    template <class Policy> bool access_with_(Op op, uint32_t addr, Cache* next_level);
+    template <class Policy> void allocate_with_(uint32_t addr, Cache* next_level, bool make_dirty, bool fetch);
+    template <class Policy> void repl_hit_(uint64_t set, uint32_t way);
+    template <class Policy> void repl_fill_(uint64_t set, uint32_t way);
+    template <class Policy> uint32_t repl_victim_(uint64_t set);
 
     // Push a dirty victim to next level or to memory if next_level == nullptr.
     void writeback_down(uint32_t victim_block_addr, Cache* next_level);
 
+    // ---- Write policies (see WritePolicy) ----
+    bool write_through_() const {
+        return cfg_.write == WritePolicy::WriteThroughAllocate ||
+               cfg_.write == WritePolicy::WriteThroughNoAllocate;
+    }
+    bool write_allocate_() const {
+        return cfg_.write == WritePolicy::WriteBackAllocate ||
+               cfg_.write == WritePolicy::WriteThroughAllocate;
+    }
+    // A write of 'block_addr' leaving this level: through the write buffer
+    // if there is one, else straight to write_down_now_.
+    void send_write_down_(uint32_t block_addr, Cache* next_level);
+    void write_down_now_(uint32_t block_addr, Cache* next_level);
+    // Before reading 'block_addr' from below, drain a pending write to it.
+    void drain_pending_write_(uint32_t block_addr, Cache* next_level) {
+        if (write_buffer_ && write_buffer_->take(block_addr)) write_down_now_(block_addr, next_level);
+    }
+
+    // ---- Inclusion (see Inclusion) ----
+    // Drop 'block_addr' if present (victim cache included); returns whether
+    // it was, and whether dirty.
+    bool invalidate_block_(uint32_t block_addr, bool& was_dirty);
+    // Inclusive: invalidate an evicted block in every level above; returns
+    // whether any of those copies was dirty.
+    bool back_invalidate_(uint32_t block_addr);
+    // Exclusive: the level above missed on 'addr'. Hand the block up (a hit
+    // drops our copy; a miss fetches from below without allocating here).
+    // Returns whether the block comes up dirty.
+    bool take_block_(uint32_t addr);
+    // Exclusive: insert a line evicted by the level above.
+    void victim_fill_(uint32_t block_addr, bool dirty);
+
     // Turn a block-aligned address (addr with offset=0) into the exact same form at lower level.
     uint32_t block_aligned(uint32_t addr) const { return addr & ~((uint32_t)cfg_.block_bytes - 1U); }
 
@@ -0,0 +1,94 @@
+#ifndef CACHE_FIXED_H
+#define CACHE_FIXED_H
+
+#include <cstdint>
+#include <cstddef>
+
+#include "cache.h"
+
+// Compile-time specialized access path for the geometries we sweep most
+// (block 16/32/64, assoc 1/2/4/8/16). Block size and associativity are
+// template constants, so the offset shift is an immediate and the way loop is
+// fully unrolled; the number of sets stays a runtime mask. Misses fall back to
+// the generic allocate_on_miss, which is off the hot path. LRU and WBWA only.
+
+constexpr uint32_t cache_ilog2(uint32_t x) { return x <= 1 ? 0 : 1 + cache_ilog2(x >> 1); }
+
+#ifndef CACHE_LRU_AGE
+inline void Cache::lru_promote_(uint64_t set, uint32_t w) {
+    // Unlink 'w' and splice it in at the MRU head.
+    uint32_t& head = lru_head_[set];
+    if (head == w) return;
+    uint32_t* prev = &lru_prev_[slot(set, 0)];
+    uint32_t* next = &lru_next_[slot(set, 0)];
+    uint32_t& tail = lru_tail_[set];
+
+    const uint32_t p = prev[w];
+    const uint32_t n = next[w];
+    next[p] = n;
+    if (tail == w) tail = p;
+    else           prev[n] = p;
+
+    next[w]    = head;
+    prev[head] = w;
+    head       = w;
+}
+#endif
+
+template <uint32_t BlockBytes, uint32_t Assoc>
+bool Cache::has_fixed_kernel() const {
+#ifdef CACHE_LRU_AGE
+    return false;                   // fixed kernels assume the list LRU
+#else
+    return cfg_.block_bytes == BlockBytes && cfg_.assoc == Assoc && cfg_.repl == ReplPolicy::Lru &&
+           cfg_.write == WritePolicy::WriteBackAllocate &&
+           !fa_index_ && !prefetcher_ && !classifier_ && !reuse_;
+#endif
+}
+
+template <uint32_t BlockBytes, uint32_t Assoc>
+inline bool Cache::access_fixed(Op op, uint32_t addr, Cache* next_level) {
+    static_assert(BlockBytes && (BlockBytes & (BlockBytes - 1)) == 0, "block size must be a power of two");
+    static_assert(Assoc > 0, "associativity must be positive");
+#ifdef CACHE_LRU_AGE
+    return access(op, addr, next_level);
+#else
+    constexpr uint32_t kOffBits = cache_ilog2(BlockBytes);
+
+    const uint32_t    blk  = addr >> kOffBits;
+    const uint64_t    set  = blk & idx_mask_;
+    const uint32_t    tag  = static_cast<uint32_t>(static_cast<uint64_t>(blk) >> idx_bits_);
+    const std::size_t base = static_cast<std::size_t>(set) * Assoc;
+
+    if (op == Op::Read) stats_.reads += 1;
+    else                stats_.writes += 1;
+
+    // Unrolled compare; a tag is resident in at most one valid way, so the
+    // last match is the only match.
+    const uint32_t* tags  = &tags_[base];
+    const uint8_t*  state = &state_[base];
+    int way = -1;
+    if (Assoc >= 12 && match_fn_) {
+        // Wide sets: the SIMD kernel beats a 16-way unrolled scalar compare.
+        way = match_fn_(tags, state, static_cast<int>(Assoc), tag, kValid);
+    } else {
+#pragma GCC unroll 16
+        for (uint32_t w = 0; w < Assoc; ++w) {
+            if (tags[w] == tag && (state[w] & kValid)) way = static_cast<int>(w);
+        }
+    }
+
+    if (way >= 0) {
+        if (op == Op::Write) state_[base + way] |= kDirty; // WBWA: write hits mark dirty
+        lru_promote_(set, static_cast<uint32_t>(way));
+        return true;
+    }
+
+    if (op == Op::Read) stats_.read_misses += 1;
+    else                stats_.write_misses += 1;
+    allocate_on_miss(addr, next_level, op == Op::Write);
+    return false;
+#endif
+}
+
+#endif // CACHE_FIXED_H
@@ -0,0 +1,59 @@
+/***********************************************************************************
+ * File:        fa_index.cc
+ * Author:      Connor Savugot
+ * Created:     2025-09-21
+ * Updated:     2025-09-21
+ * Version:     1.0
+ *
+ * Description: Open-addressing tag -> way index for fully-associative caches.
+ ***********************************************************************************/
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "fa_index.h"
+
+FullyAssocIndex::FullyAssocIndex(std::size_t ways) {
+    // Power-of-two table with at least 2x the ways -> load factor <= 0.5.
+    std::size_t cap  = 1;
+    uint32_t    bits = 0;
+    while (cap < 2 * ways) { cap <<= 1; ++bits; }
+    if (bits == 0) { cap = 2; bits = 1; }
+    keys_.assign(cap, 0);
+    ways_.assign(cap, kEmpty);
+    mask_  = cap - 1;
+    shift_ = 64 - bits;
+}
+
+void FullyAssocIndex::insert(uint32_t tag, uint32_t way) {
+    std::size_t i = home(tag);
+    while (ways_[i] != kEmpty) i = (i + 1) & mask_;
+    keys_[i] = tag;
+    ways_[i] = way;
+}
+
+void FullyAssocIndex::erase(uint32_t tag) {
+    std::size_t i = home(tag);
+    while (true) {
+        if (ways_[i] == kEmpty) return;
+        if (keys_[i] == tag) break;
+        i = (i + 1) & mask_;
+    }
+    // Backward-shift: pull later entries of the cluster into the hole when
+    // their home slot does not lie cyclically in (hole, j].
+    std::size_t hole = i;
+    std::size_t j    = i;
+    while (true) {
+        j = (j + 1) & mask_;
+        if (ways_[j] == kEmpty) break;
+        const std::size_t h = home(keys_[j]);
+        const bool in_range = (hole <= j) ? (hole < h && h <= j)
+                                          : (hole < h || h <= j);
+        if (in_range) continue;
+        keys_[hole] = keys_[j];
+        ways_[hole] = ways_[j];
+        hole = j;
+    }
+    ways_[hole] = kEmpty;
+}
@@ -0,0 +1,47 @@
+#ifndef FA_INDEX_H
+#define FA_INDEX_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Tag -> way hash index used by Cache when the geometry is fully associative
+// (a single set), replacing the linear find_way scan with an O(1) probe.
+// Open addressing with linear probing and backward-shift deletion, so there
+// are no tombstones and probe sequences stay short at <= 50% load.
+
+class FullyAssocIndex {
+public:
+    explicit FullyAssocIndex(std::size_t ways);
+
+    // Way holding 'tag', or -1.
+    int find(uint32_t tag) const {
+        std::size_t i = home(tag);
+        while (true) {
+            const uint32_t w = ways_[i];
+            if (w == kEmpty) return -1;
+            if (keys_[i] == tag) return static_cast<int>(w);
+            i = (i + 1) & mask_;
+        }
+    }
+
+    // Precondition: 'tag' is not present.
+    void insert(uint32_t tag, uint32_t way);
+
+    // Remove 'tag' if present.
+    void erase(uint32_t tag);
+
+private:
+    static constexpr uint32_t kEmpty = 0xFFFFFFFFu;
+
+    std::size_t home(uint32_t tag) const {
+        return static_cast<std::size_t>((tag * 0x9E3779B97F4A7C15ULL) >> shift_);
+    }
+
+    std::vector<uint32_t> keys_;
+    std::vector<uint32_t> ways_;   // kEmpty marks a free slot
+    std::size_t           mask_  = 0;
+    uint32_t              shift_ = 0;
+};
+
+#endif // FA_INDEX_H
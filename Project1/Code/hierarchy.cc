@@ -0,0 +1,290 @@
+/***********************************************************************************
+ * File:        hierarchy.cc
+ * Author:      Connor Savugot
+ * Created:     2025-09-21
+ * Updated:     2025-09-21
+ * Version:     1.0
+ *
+ * Description: Builds an L1 (+ optional L2) hierarchy from CLI-style params,
+ *              or any number of levels from a hierarchy file, attaches
+ *              stream buffers to the last level when requested, runs
+ *              decoded trace batches through it, and prints its report.
+ ***********************************************************************************/
+
+#include <stdlib.h>
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "hierarchy.h"
+#include "cache_fixed.h"
+#include "stats.h"
+
+static bool is_pow2(uint32_t x) { return x && ((x & (x - 1)) == 0); }
+
+// SIZE / (ASSOC * BLOCKSIZE) sets, which must be a power of two.
+static bool sets_are_pow2(uint32_t size, uint32_t assoc, uint32_t block) {
+    const uint64_t set_bytes = static_cast<uint64_t>(assoc) * block;
+    return size % set_bytes == 0 && is_pow2(static_cast<uint32_t>(size / set_bytes));
+}
+
+bool validate_params(const cache_params_t& p, std::string& err) {
+    if (!is_pow2(p.BLOCKSIZE)) { err = "BLOCKSIZE must be a power of two"; return false; }
+    if (p.L1_SIZE == 0 || p.L1_ASSOC == 0) { err = "L1_SIZE and L1_ASSOC must be non-zero"; return false; }
+
+    auto check_level = [&](const char* name, uint32_t size, uint32_t assoc) {
+        if (!sets_are_pow2(size, assoc, p.BLOCKSIZE)) {
+            err = std::string(name) + "_SIZE / (" + name + "_ASSOC * BLOCKSIZE) must be a power of two";
+            return false;
+        }
+        return true;
+    };
+    if (!check_level("L1", p.L1_SIZE, p.L1_ASSOC)) return false;
+    if (p.L2_SIZE > 0 && p.L2_ASSOC > 0 && !check_level("L2", p.L2_SIZE, p.L2_ASSOC)) return false;
+    return true;
+}
+
+// Largest wbuf=/victim=/lat=/mshrs= value a hierarchy file may give; beyond
+// it the entry counts would only exhaust memory.
+static const unsigned long kMaxLevelOption = 1ul << 16;
+
+// Decimal value after 'prefix' chars of 'opt': digits only, at most
+// kMaxLevelOption.
+static bool parse_level_option(const std::string& opt, std::size_t prefix, uint32_t& out) {
+    const char* s = opt.c_str() + prefix;
+    if (*s < '0' || *s > '9') return false;
+    char* end = nullptr;
+    const unsigned long v = strtoul(s, &end, 10);
+    if (*end || v > kMaxLevelOption) return false;
+    out = static_cast<uint32_t>(v);
+    return true;
+}
+
+bool load_hierarchy_file(const char* path, HierarchySpec& out, std::string& err) {
+    std::ifstream in(path);
+    if (!in) { err = std::string("unable to open ") + path; return false; }
+
+    out = HierarchySpec();
+    std::string line;
+    int lineno = 0;
+    auto fail = [&](const std::string& why) {
+        err = "line " + std::to_string(lineno) + ": " + why;
+        return false;
+    };
+    while (std::getline(in, line)) {
+        ++lineno;
+        const std::size_t hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+
+        std::istringstream ss(line);
+        std::string key, extra;
+        if (!(ss >> key)) continue;                    // blank/comment line
+        if (key == "blocksize") {
+            if (!(ss >> out.blocksize) || (ss >> extra)) return fail("expected 'blocksize B'");
+            if (!is_pow2(out.blocksize)) return fail("block size must be a power of two");
+        } else if (key == "prefetch") {
+            if (!(ss >> out.pref_n >> out.pref_m) || (ss >> extra)) return fail("expected 'prefetch N M'");
+        } else if (key == "memory") {
+            if (!(ss >> out.mem_latency) || (ss >> extra)) return fail("expected 'memory LATENCY'");
+        } else if (key == "level") {
+            LevelSpec lv;
+            if (!(ss >> lv.name >> lv.size >> lv.assoc)) return fail("expected 'level NAME SIZE ASSOC [OPTIONS]'");
+            lv.hit_latency = out.levels.empty() ? 1 : 10 * (uint32_t) out.levels.size();
+            while (ss >> extra) {
+                if (extra.compare(0, 5, "wbuf=") == 0) {
+                    if (!parse_level_option(extra, 5, lv.write_buffer)) return fail("bad value for " + extra);
+                } else if (extra.compare(0, 7, "victim=") == 0) {
+                    if (!parse_level_option(extra, 7, lv.victim_cache)) return fail("bad value for " + extra);
+                } else if (extra.compare(0, 4, "lat=") == 0) {
+                    if (!parse_level_option(extra, 4, lv.hit_latency)) return fail("bad value for " + extra);
+                } else if (extra.compare(0, 6, "mshrs=") == 0) {
+                    if (!parse_level_option(extra, 6, lv.mshrs)) return fail("bad value for " + extra);
+                } else if (!parse_repl_policy(extra.c_str(), lv.repl) &&
+                           !parse_inclusion(extra.c_str(), lv.inclusion) &&
+                           !parse_write_policy(extra.c_str(), lv.write)) {
+                    return fail("unknown level option " + extra);
+                }
+            }
+            for (const LevelSpec& o : out.levels) {
+                if (o.name == lv.name) return fail("duplicate level " + lv.name);
+            }
+            out.levels.push_back(lv);
+        } else {
+            return fail("unknown directive " + key);
+        }
+    }
+
+    if (out.blocksize == 0) { err = "missing 'blocksize'"; return false; }
+    if (out.levels.empty()) { err = "no levels"; return false; }
+    return validate_hierarchy_spec(out, err);
+}
+
+HierarchySpec hierarchy_spec(const cache_params_t& params, ReplPolicy l1_repl, ReplPolicy l2_repl) {
+    HierarchySpec spec;
+    spec.blocksize = params.BLOCKSIZE;
+    spec.pref_n    = params.PREF_N;
+    spec.pref_m    = params.PREF_M;
+
+    LevelSpec l1;
+    l1.name  = "L1";
+    l1.size  = params.L1_SIZE;
+    l1.assoc = params.L1_ASSOC;
+    l1.repl  = l1_repl;
+    spec.levels.push_back(l1);
+    if (params.L2_SIZE > 0 && params.L2_ASSOC > 0) {
+        LevelSpec l2;
+        l2.name  = "L2";
+        l2.size  = params.L2_SIZE;
+        l2.assoc = params.L2_ASSOC;
+        l2.repl  = l2_repl;
+        l2.hit_latency = 10;
+        spec.levels.push_back(l2);
+    }
+    return spec;
+}
+
+bool validate_hierarchy_spec(const HierarchySpec& spec, std::string& err) {
+    if (!is_pow2(spec.blocksize)) { err = "BLOCKSIZE must be a power of two"; return false; }
+    for (std::size_t i = 0; i < spec.levels.size(); ++i) {
+        const LevelSpec& lv = spec.levels[i];
+        if (lv.size == 0 || lv.assoc == 0 || !sets_are_pow2(lv.size, lv.assoc, spec.blocksize)) {
+            err = lv.name + ": SIZE / (ASSOC * BLOCKSIZE) must be a power of two";
+            return false;
+        }
+        if (!validate_repl(lv.repl, lv.assoc, err)) { err = lv.name + ": " + err; return false; }
+        if (i == 0 && lv.inclusion != Inclusion::Nine) {
+            err = lv.name + ": the first level has no level above it to include or exclude";
+            return false;
+        }
+        // A write-through copy above would be re-allocated in the exclusive
+        // level by the write it sends down.
+        const bool write_through = lv.write == WritePolicy::WriteThroughAllocate ||
+                                   lv.write == WritePolicy::WriteThroughNoAllocate;
+        if (write_through && i + 1 < spec.levels.size() &&
+            spec.levels[i + 1].inclusion == Inclusion::Exclusive) {
+            err = lv.name + ": write-through above an exclusive level";
+            return false;
+        }
+        // Only the first level can block: a lower level always has the
+        // request of the miss above it outstanding.
+        if (i > 0 && lv.mshrs == 0) {
+            err = lv.name + ": needs at least one MSHR";
+            return false;
+        }
+    }
+    return true;
+}
+
+Hierarchy::Hierarchy(const cache_params_t& params, ReplPolicy l1_repl, ReplPolicy l2_repl)
+: Hierarchy(hierarchy_spec(params, l1_repl, l2_repl)) {}
+
+Hierarchy::Hierarchy(const HierarchySpec& spec) : spec_(spec) {
+    params_ = cache_params_t();
+    params_.BLOCKSIZE = spec.blocksize;
+    params_.L1_SIZE   = spec.levels[0].size;
+    params_.L1_ASSOC  = spec.levels[0].assoc;
+    if (spec.levels.size() > 1) {
+        params_.L2_SIZE  = spec.levels[1].size;
+        params_.L2_ASSOC = spec.levels[1].assoc;
+    }
+    params_.PREF_N = spec.pref_n;
+    params_.PREF_M = spec.pref_m;
+
+    for (const LevelSpec& lv : spec.levels) {
+        levels_.push_back(std::make_unique<Cache>(CacheConfig {
+            lv.name,
+            (std::size_t)lv.size,
+            (std::size_t)lv.assoc,
+            (std::size_t)spec.blocksize,
+            lv.repl,
+            lv.inclusion,
+            lv.write
+        }));
+        levels_.back()->attach_write_buffer(lv.write_buffer);
+        levels_.back()->attach_victim_cache(lv.victim_cache);
+    }
+    for (std::size_t i = 0; i + 1 < levels_.size(); ++i) {
+        levels_[i]->set_next_level(levels_[i + 1].get());
+    }
+
+    // Stream buffers sit in front of memory, i.e. at the last level.
+    levels_.back()->attach_prefetcher(params_.PREF_N, params_.PREF_M);
+
+    batch_fn_ = select_batch_fn_(*levels_[0]);
+}
+
+std::vector<const Cache*> Hierarchy::levels() const {
+    std::vector<const Cache*> out;
+    for (const auto& c : levels_) out.push_back(c.get());
+    return out;
+}
+
+bool Hierarchy::has_inclusion_policy() const {
+    for (const auto& c : levels_) {
+        if (c->config().inclusion != Inclusion::Nine) return true;
+    }
+    return false;
+}
+
+void Hierarchy::drain_write_buffers() {
+    for (auto& c : levels_) c->drain_write_buffer();
+}
+
+template <uint32_t BlockBytes, uint32_t Assoc>
+void Hierarchy::run_batch_fixed_(Hierarchy& h, const uint32_t* addrs, const uint8_t* writes, std::size_t n) {
+    Cache& l1 = h.l1();
+    Cache* l2 = h.l2();
+    for (std::size_t i = 0; i < n; ++i) {
+        l1.access_fixed<BlockBytes, Assoc>(writes[i] ? Cache::Op::Write : Cache::Op::Read, addrs[i], l2);
+    }
+}
+
+void Hierarchy::run_batch_generic_(Hierarchy& h, const uint32_t* addrs, const uint8_t* writes, std::size_t n) {
+    Cache& l1 = h.l1();
+    Cache* l2 = h.l2();
+    for (std::size_t i = 0; i < n; ++i) {
+        l1.access(writes[i] ? Cache::Op::Write : Cache::Op::Read, addrs[i], l2);
+    }
+}
+
+Hierarchy::BatchFn Hierarchy::select_batch_fn_(const Cache& l1) {
+#ifndef CACHE_NO_FIXED
+#define HIERARCHY_TRY_FIXED(B, A) \
+    if (l1.has_fixed_kernel<B, A>()) return &Hierarchy::run_batch_fixed_<B, A>;
+#define HIERARCHY_TRY_BLOCK(B) \
+    HIERARCHY_TRY_FIXED(B, 1) HIERARCHY_TRY_FIXED(B, 2) HIERARCHY_TRY_FIXED(B, 4) \
+    HIERARCHY_TRY_FIXED(B, 8) HIERARCHY_TRY_FIXED(B, 16)
+    HIERARCHY_TRY_BLOCK(16)
+    HIERARCHY_TRY_BLOCK(32)
+    HIERARCHY_TRY_BLOCK(64)
+#undef HIERARCHY_TRY_BLOCK
+#undef HIERARCHY_TRY_FIXED
+#else
+    (void)l1;
+#endif
+    return &Hierarchy::run_batch_generic_;
+}
+
+void Hierarchy::enable_miss_classification() {
+    for (auto& c : levels_) c->enable_miss_classification();
+    batch_fn_ = select_batch_fn_(l1());   // classification needs the generic path
+}
+
+void Hierarchy::enable_reuse_histograms() {
+    for (auto& c : levels_) c->enable_reuse_histogram();
+    batch_fn_ = select_batch_fn_(l1());
+}
+
+void Hierarchy::print_report(std::ostream& os, const char* trace_name) const {
+    if (levels_.size() > 2) {
+        print_levels_config(os, params_, levels(), trace_name);
+    } else {
+        print_sim_config(os, params_, trace_name, &l1(), l2());
+    }
+    print_final_report(os, levels());
+}
@@ -0,0 +1,140 @@
+#ifndef HIERARCHY_H
+#define HIERARCHY_H
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "sim.h"
+#include "cache.h"
+
+// Hierarchy file (./sim --hier): any number of levels, L1 first, each one
+// forwarding its misses and writebacks to the next and the last to memory.
+//
+//   blocksize 32                 # required, shared by every level
+//   level L1    8192     1  wtnwa wbuf=8 victim=8   # level NAME SIZE ASSOC [OPTIONS]
+//   level L2    262144   8  srrip
+//   level L3    4194304  16 drrip inclusive
+//   prefetch 3 4                 # optional: PREF_N PREF_M on the last level
+//   memory 200                   # optional: memory latency in cycles (--timing)
+//
+// Options after ASSOC, in any order: a replacement policy, a write policy
+// (wbwa, wbnwa, wtwa, wtnwa), 'wbuf=N' for an N-entry write buffer towards
+// the level below, 'victim=N' for an N-entry victim cache and, below L1, an
+// inclusion policy towards the level above (nine, inclusive, exclusive; see
+// cache.h). For --timing (see timing.h), 'lat=N' sets the hit latency in
+// cycles (default 1 for the first level, 10 per level below it) and
+// 'mshrs=N' the miss-status holding registers (default 8; 0 on the first
+// level makes it a blocking cache). These four take 0..65536.
+// Blank lines and '#' comments are ignored.
+struct LevelSpec {
+    std::string name;
+    uint32_t    size  = 0;
+    uint32_t    assoc = 0;
+    ReplPolicy  repl  = ReplPolicy::Lru;
+    Inclusion   inclusion = Inclusion::Nine;
+    WritePolicy write = WritePolicy::WriteBackAllocate;
+    uint32_t    write_buffer = 0;   // entries; 0 = none
+    uint32_t    victim_cache = 0;   // entries; 0 = none
+    uint32_t    hit_latency  = 1;   // cycles (timing model only)
+    uint32_t    mshrs        = 8;   // outstanding misses (timing model only)
+};
+
+struct HierarchySpec {
+    uint32_t               blocksize = 0;
+    std::vector<LevelSpec> levels;
+    uint32_t               pref_n = 0;
+    uint32_t               pref_m = 0;
+    uint32_t               mem_latency = 100;   // cycles (timing model only)
+};
+
+// Parse and validate 'path'. On failure returns false and fills 'err' (with
+// the line number where there is one).
+bool load_hierarchy_file(const char* path, HierarchySpec& out, std::string& err);
+
+// The L1 (+ L2) hierarchy of the ./sim command line, with default policies
+// apart from replacement.
+HierarchySpec hierarchy_spec(const cache_params_t& params,
+                             ReplPolicy l1_repl = ReplPolicy::Lru,
+                             ReplPolicy l2_repl = ReplPolicy::Lru);
+
+// Check every level's geometry and policy combination (replacement vs.
+// associativity, no inclusion on the first level, no write-through above an
+// exclusive level, MSHRs below the first level). On failure, 'err' names the level and says why.
+bool validate_hierarchy_spec(const HierarchySpec& spec, std::string& err);
+
+// One simulated cache hierarchy: an L1 Cache plus an optional L2 (when
+// L2_SIZE and L2_ASSOC are both non-zero) from CLI-style parameters, or any
+// number of levels from a HierarchySpec. Used by ./sim and by sweep mode,
+// where many hierarchies consume the same trace batches. Each level uses
+// true LRU, NINE inclusion and WBWA unless other policies are given.
+
+class Hierarchy {
+public:
+    explicit Hierarchy(const cache_params_t& params,
+                       ReplPolicy l1_repl = ReplPolicy::Lru,
+                       ReplPolicy l2_repl = ReplPolicy::Lru);
+
+    // params() then describes the first two levels and the prefetcher.
+    explicit Hierarchy(const HierarchySpec& spec);
+
+    const cache_params_t& params() const { return params_; }
+    const HierarchySpec&  spec()   const { return spec_; }
+    Cache&       l1()       { return *levels_[0]; }
+    const Cache& l1() const { return *levels_[0]; }
+    Cache*       l2()       { return levels_.size() > 1 ? levels_[1].get() : nullptr; }   // nullptr if no L2
+    const Cache* l2() const { return levels_.size() > 1 ? levels_[1].get() : nullptr; }
+
+    // Levels in order from L1 towards memory.
+    std::size_t  depth() const { return levels_.size(); }
+    Cache&       level(std::size_t i)       { return *levels_[i]; }
+    const Cache& level(std::size_t i) const { return *levels_[i]; }
+    std::vector<const Cache*> levels() const;
+
+    // True if any level is inclusive or exclusive (back-invalidations and
+    // victim fills need every level on one thread: no --pipeline).
+    bool has_inclusion_policy() const;
+
+    // Send every write still pending in a write buffer down, L1 first.
+    // Call once the trace is done, before reading stats.
+    void drain_write_buffers();
+
+    // Simulate 'n' decoded records (writes[i] != 0 -> write) in order.
+    // Uses the geometry-specialized L1 kernel when one matches.
+    void run_batch(const uint32_t* addrs, const uint8_t* writes, std::size_t n) {
+        batch_fn_(*this, addrs, writes, n);
+    }
+
+    // Three-C miss classification on every level (see miss_class.h).
+    void enable_miss_classification();
+
+    // Reuse-distance histograms on every level (see reuse_dist.h).
+    void enable_reuse_histograms();
+
+    // Configuration block and final report, exactly as ./sim prints them
+    // (the reference format for up to two levels, see stats.h).
+    void print_report(std::ostream& os, const char* trace_name) const;
+
+private:
+    typedef void (*BatchFn)(Hierarchy&, const uint32_t*, const uint8_t*, std::size_t);
+
+    cache_params_t                      params_;
+    HierarchySpec                       spec_;
+    std::vector<std::unique_ptr<Cache>> levels_;
+    BatchFn                             batch_fn_;
+
+
+    static BatchFn select_batch_fn_(const Cache& l1);
+    template <uint32_t BlockBytes, uint32_t Assoc>
+    static void run_batch_fixed_(Hierarchy& h, const uint32_t* addrs, const uint8_t* writes, std::size_t n);
+    static void run_batch_generic_(Hierarchy& h, const uint32_t* addrs, const uint8_t* writes, std::size_t n);
+};
+
+// Check that 'p' describes a buildable hierarchy (power-of-two block size and
+// set counts, sizes divisible by assoc * block). On failure, 'err' says why.
+bool validate_params(const cache_params_t& p, std::string& err);
+
+#endif // HIERARCHY_H
@@ -0,0 +1,98 @@
+/***********************************************************************************
+ * File:        interval.cc
+ * Author:      Connor Savugot
+ * Created:     2025-09-21
+ * Updated:     2025-09-21
+ * Version:     1.0
+ *
+ * Description: Periodic L1/L2 counter snapshots streamed to a CSV writer
+ *              thread through an SPSC ring (per-interval phase statistics).
+ ***********************************************************************************/
+
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+
+#include "interval.h"
+
+// Snapshots in flight between the simulation and writer threads.
+static const std::size_t kIntervalRing = 1024;
+
+IntervalRecorder::IntervalRecorder(uint64_t interval, const char* out, const Cache& l1, const Cache* l2)
+: l1_(l1), l2_(l2), interval_(interval ? interval : 1), left_(interval_), ring_(kIntervalRing) {
+    if (out) {
+        fp_     = fopen(out, "w");
+        own_fp_ = true;
+    } else {
+        fp_ = stderr;
+    }
+    if (!fp_) return;
+    fputs("interval,end_record,l1_accesses,l1_misses,l1_miss_rate,l1_writebacks,"
+          "l2_reads,l2_read_misses,l2_miss_rate,l2_writebacks,memory_traffic\n", fp_);
+    writer_ = std::thread([this] { write_loop_(); });
+}
+
+IntervalRecorder::~IntervalRecorder() {
+    finish();
+}
+
+void IntervalRecorder::snapshot_() {
+    IntervalSample s;
+    records_ += interval_ - left_;
+    s.records = records_;
+    s.l1      = l1_.stats();
+    if (l2_) s.l2 = l2_->stats();
+    if (fp_) ring_.push(s);
+    left_ = interval_;
+}
+
+void IntervalRecorder::finish() {
+    if (finished_) return;
+    finished_ = true;
+    if (left_ != interval_) snapshot_();   // trailing partial interval
+    ring_.close();
+    if (writer_.joinable()) writer_.join();
+    if (fp_) fflush(fp_);
+    if (own_fp_ && fp_) fclose(fp_);
+    fp_ = nullptr;
+}
+
+static double rate(uint64_t num, uint64_t den) {
+    return den ? static_cast<double>(num) / static_cast<double>(den) : 0.0;
+}
+
+void IntervalRecorder::write_loop_() {
+    IntervalSample batch[64];
+    IntervalSample prev;
+    uint64_t index = 0;
+    std::size_t n;
+    while ((n = ring_.pop_bulk(batch, 64)) > 0) {
+        for (std::size_t i = 0; i < n; ++i) {
+            const IntervalSample& cur = batch[i];
+            const AccessStats& a  = cur.l1;
+            const AccessStats& b  = cur.l2;
+            const AccessStats& pa = prev.l1;
+            const AccessStats& pb = prev.l2;
+
+            const uint64_t l1_acc   = (a.reads + a.writes) - (pa.reads + pa.writes);
+            const uint64_t l1_miss  = (a.read_misses + a.write_misses) - (pa.read_misses + pa.write_misses);
+            const uint64_t l1_wb    = a.writebacks - pa.writebacks;
+            const uint64_t l2_reads = b.reads - pb.reads;
+            const uint64_t l2_rmiss = b.read_misses - pb.read_misses;
+            const uint64_t l2_wb    = b.writebacks - pb.writebacks;
+            const uint64_t traffic  =
+                (a.memory_reads + a.memory_writes + a.pref_issued +
+                 b.memory_reads + b.memory_writes + b.pref_issued) -
+                (pa.memory_reads + pa.memory_writes + pa.pref_issued +
+                 pb.memory_reads + pb.memory_writes + pb.pref_issued);
+
+            fprintf(fp_, "%llu,%llu,%llu,%llu,%.6f,%llu,%llu,%llu,%.6f,%llu,%llu\n",
+                    (unsigned long long) index++, (unsigned long long) cur.records,
+                    (unsigned long long) l1_acc, (unsigned long long) l1_miss, rate(l1_miss, l1_acc),
+                    (unsigned long long) l1_wb,
+                    (unsigned long long) l2_reads, (unsigned long long) l2_rmiss, rate(l2_rmiss, l2_reads),
+                    (unsigned long long) l2_wb, (unsigned long long) traffic);
+            prev = cur;
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef INTERVAL_H
+#define INTERVAL_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#include "cache.h"
+#include "spsc_ring.h"
+
+// Interval (phase) statistics: every K trace records the cumulative L1/L2
+// counters are snapshotted into a lock-free ring, and a writer thread turns
+// consecutive snapshots into one CSV row of per-interval deltas (accesses,
+// misses, miss rates, writebacks, memory traffic). The simulation thread
+// only decrements a counter per record and copies two AccessStats per
+// interval, so it never waits on formatting or I/O.
+//
+// CSV columns:
+//   interval,end_record,l1_accesses,l1_misses,l1_miss_rate,l1_writebacks,
+//   l2_reads,l2_read_misses,l2_miss_rate,l2_writebacks,memory_traffic
+// l2_miss_rate is demand read misses / reads, as in the final report, and
+// memory_traffic counts the same events as report line q.
+
+struct IntervalSample {
+    uint64_t    records = 0;   // records simulated when the snapshot was taken
+    AccessStats l1;
+    AccessStats l2;
+};
+
+class IntervalRecorder {
+public:
+    // 'out' is a file path, or nullptr for stderr. 'l2' may be nullptr.
+    IntervalRecorder(uint64_t interval, const char* out, const Cache& l1, const Cache* l2);
+    ~IntervalRecorder();
+
+    IntervalRecorder(const IntervalRecorder&) = delete;
+    IntervalRecorder& operator=(const IntervalRecorder&) = delete;
+
+    bool is_open() const { return fp_ != nullptr; }
+
+    // Call once after every simulated record.
+    void operator()() {
+        if (--left_ == 0) snapshot_();
+    }
+
+    // Emit the final partial interval and wait for the writer. Idempotent.
+    void finish();
+
+private:
+    const Cache&   l1_;
+    const Cache*   l2_;
+    const uint64_t interval_;
+    uint64_t       left_;
+    uint64_t       records_ = 0;   // records covered by earlier snapshots
+
+    FILE*                    fp_ = nullptr;
+    bool                     own_fp_ = false;
+    SpscRing<IntervalSample> ring_;
+    std::thread              writer_;
+    bool                     finished_ = false;
+
+    void snapshot_();
+    void write_loop_();
+};
+
+#endif // INTERVAL_H
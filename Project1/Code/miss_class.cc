@@ -0,0 +1,68 @@
+/***********************************************************************************
+ * File:        miss_class.cc
+ * Author:      Connor Savugot
+ * Created:     2025-09-21
+ * Updated:     2025-09-21
+ * Version:     1.0
+ *
+ * Description: Compulsory / capacity / conflict miss classification against
+ *              a shadow fully-associative LRU cache of the same capacity.
+ ***********************************************************************************/
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "miss_class.h"
+
+MissClassStats& MissClassStats::operator+=(const MissClassStats& o) {
+    compulsory += o.compulsory;
+    capacity   += o.capacity;
+    conflict   += o.conflict;
+    return *this;
+}
+
+MissClassifier::MissClassifier(std::size_t lines)
+: index_(lines), blocks_(lines, 0), prev_(lines, 0), next_(lines, 0) {}
+
+void MissClassifier::promote_(uint32_t s) {
+    if (s == head_) return;
+    const uint32_t p = prev_[s];
+    const uint32_t n = next_[s];
+    next_[p] = n;
+    if (s == tail_) tail_ = p;
+    else            prev_[n] = p;
+    next_[s]     = head_;
+    prev_[head_] = s;
+    head_        = s;
+}
+
+void MissClassifier::access(uint32_t block, bool miss) {
+    const int hit_slot = index_.find(block);
+    bool first_ref = false;
+    if (hit_slot >= 0) {
+        promote_(static_cast<uint32_t>(hit_slot));
+    } else {
+        // A shadow hit implies the block was seen before, so the seen set
+        // only needs a probe on shadow misses.
+        first_ref = seen_.exchange(block, 0) == BlockMap::kNone;
+        uint32_t s;
+        if (used_ < blocks_.size()) {
+            // Still filling: append at the MRU end.
+            s = used_++;
+            if (s == 0) { head_ = tail_ = 0; }
+            else        { next_[s] = head_; prev_[head_] = s; head_ = s; }
+        } else {
+            s = tail_;
+            index_.erase(blocks_[s]);
+            promote_(s);
+        }
+        blocks_[s] = block;
+        index_.insert(block, s);
+    }
+
+    if (!miss) return;
+    if (first_ref)         stats_.compulsory += 1;
+    else if (hit_slot < 0) stats_.capacity   += 1;
+    else                   stats_.conflict   += 1;
+}
@@ -0,0 +1,54 @@
+#ifndef MISS_CLASS_H
+#define MISS_CLASS_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "block_map.h"
+#include "fa_index.h"
+
+// Three-C miss classification (Hill & Smith) for one cache level:
+//   compulsory - first reference to the block at this level
+//   capacity   - also misses in a fully-associative LRU cache of equal capacity
+//   conflict   - would have hit in that fully-associative cache
+// The "ever seen" set is a growing open-addressing map; the shadow
+// fully-associative cache is a FullyAssocIndex plus an O(1) LRU list, so each
+// access costs one or two hash probes and a list splice.
+
+struct MissClassStats {
+    uint64_t compulsory = 0;
+    uint64_t capacity   = 0;
+    uint64_t conflict   = 0;
+
+    MissClassStats& operator+=(const MissClassStats& o);
+};
+
+class MissClassifier {
+public:
+    // 'lines' = capacity of the classified cache in blocks (sets * assoc).
+    explicit MissClassifier(std::size_t lines);
+
+    // Every demand access to the cache, in order; 'miss' is true if the real
+    // cache counted it as a miss (that access is then classified).
+    void access(uint32_t block, bool miss);
+
+    const MissClassStats& stats() const { return stats_; }
+
+private:
+    // Shadow fully-associative LRU: slot -> block, recency list over slots.
+    FullyAssocIndex       index_;      // block -> slot
+    std::vector<uint32_t> blocks_;
+    std::vector<uint32_t> prev_;
+    std::vector<uint32_t> next_;
+    uint32_t              head_ = 0;   // MRU slot
+    uint32_t              tail_ = 0;   // LRU slot
+    uint32_t              used_ = 0;   // slots filled so far
+
+    BlockMap       seen_;              // blocks ever referenced (value unused)
+    MissClassStats stats_;
+
+    void promote_(uint32_t s);
+};
+
+#endif // MISS_CLASS_H
@@ -0,0 +1,43 @@
+/***********************************************************************************
+ * File:        pipeline.cc
+ * Author:      Connor Savugot
+ * Created:     2025-09-21
+ * Updated:     2025-09-21
+ * Version:     1.0
+ *
+ * Description: L2 consumer thread for pipelined L1 -> L2 simulation.
+ ***********************************************************************************/
+
+#include <cstdint>
+#include <thread>
+
+#include "pipeline.h"
+
+L2Pipeline::L2Pipeline(Cache& l1, Cache& l2, std::size_t ring_capacity)
+: l1_(l1), l2_(l2), ring_(ring_capacity) {
+    l1_.set_miss_queue(&ring_);
+    worker_ = std::thread([this]{ consume_(); });
+}
+
+L2Pipeline::~L2Pipeline() { finish(); }
+
+void L2Pipeline::finish() {
+    if (finished_) return;
+    finished_ = true;
+    ring_.close();
+    worker_.join();
+    l1_.set_miss_queue(nullptr);
+}
+
+void L2Pipeline::consume_() {
+    uint64_t events[256];
+    std::size_t n;
+    while ((n = ring_.pop_bulk(events, 256)) != 0) {
+        for (std::size_t i = 0; i < n; ++i) {
+            Cache::Op op;
+            uint32_t  addr;
+            Cache::decode_miss_event(events[i], op, addr);
+            l2_.access(op, addr, l2_.next_level());
+        }
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <cstdint>
+#include <thread>
+
+#include "cache.h"
+#include "spsc_ring.h"
+
+// Pipelined two-level simulation. L2 state depends only on the ordered
+// stream of L1 misses (reads) and writebacks (writes), so L1 runs on the
+// calling thread and, instead of calling L2 directly, pushes those events
+// into a lock-free SPSC ring; a dedicated thread drains the ring into L2.
+// Final state and stats are identical to the synchronous path.
+
+class L2Pipeline {
+public:
+    // 'l1' forwards its lower-level traffic to this pipeline until finish().
+    L2Pipeline(Cache& l1, Cache& l2, std::size_t ring_capacity = 1u << 14);
+    ~L2Pipeline();
+
+    L2Pipeline(const L2Pipeline&) = delete;
+    L2Pipeline& operator=(const L2Pipeline&) = delete;
+
+    // Close the ring, wait for L2 to drain it, and detach from L1.
+    void finish();
+
+private:
+    void consume_();
+
+    Cache&                      l1_;
+    Cache&                      l2_;
+    Cache::MissQueue            ring_;
+    std::thread                 worker_;
+    bool                        finished_ = false;
+};
+
+#endif // PIPELINE_H
@@ -0,0 +1,65 @@
+/***********************************************************************************
+ * File:        prefetch.cc
+ * Author:      Connor Savugot
+ * Created:     2025-09-21
+ * Updated:     2025-09-21
+ * Version:     1.0
+ *
+ * Description: Stream-buffer prefetcher for the last-level cache (PREF_N
+ *              buffers x PREF_M blocks, LRU among buffers).
+ ***********************************************************************************/
+
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <vector>
+
+#include "prefetch.h"
+
+StreamPrefetcher::StreamPrefetcher(uint32_t buffers, uint32_t blocks_per_buffer)
+: depth_(blocks_per_buffer), first_(buffers, 0), valid_(buffers, 0), order_(buffers) {
+    for (uint32_t i = 0; i < buffers; ++i) order_[i] = i;
+}
+
+void StreamPrefetcher::make_mru_(std::size_t pos) {
+    const uint32_t b = order_[pos];
+    for (std::size_t i = pos; i > 0; --i) order_[i] = order_[i - 1];
+    order_[0] = b;
+}
+
+bool StreamPrefetcher::access(uint32_t block, bool cache_hit, uint64_t& issued) {
+    issued = 0;
+    for (std::size_t pos = 0; pos < order_.size(); ++pos) {
+        const uint32_t b = order_[pos];
+        if (!valid_[b]) continue;
+        const uint32_t k = block - first_[b];   // wraps -> huge when block < first
+        if (k < depth_) {
+            // Hit at position k: drop X and everything before it, refill.
+            first_[b] = block + 1;
+            issued    = k + 1;
+            make_mru_(pos);
+            return true;
+        }
+    }
+
+    if (!cache_hit) {
+        // New stream in the LRU buffer.
+        const std::size_t pos = order_.size() - 1;
+        const uint32_t b = order_[pos];
+        first_[b] = block + 1;
+        valid_[b] = 1;
+        issued    = depth_;
+        make_mru_(pos);
+    }
+    return false;
+}
+
+void StreamPrefetcher::print_contents(std::ostream& os) const {
+    for (uint32_t b : order_) {
+        if (!valid_[b]) continue;
+        for (uint32_t i = 0; i < depth_; ++i) {
+            os << " " << std::hex << (first_[b] + i) << std::dec << " ";
+        }
+        os << "\n";
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef PREFETCH_H
+#define PREFETCH_H
+
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+// Stream-buffer prefetcher (PREF_N buffers of PREF_M blocks) attached to the
+// last-level Cache. A buffer always holds M consecutive block numbers, so it
+// is stored as (valid, first block); recency among buffers is an MRU-first
+// list of buffer indices.
+//
+// On every demand access to block X of the attached cache:
+//   cache miss, buffer miss -> new stream X+1..X+M in the LRU buffer (M prefetches)
+//   cache miss, buffer hit  -> X comes from the buffer, not the next level
+//   cache hit,  buffer miss -> nothing
+//   cache hit,  buffer hit  -> buffer re-synchronizes to X+1..X+M
+// A buffer hit at position k issues k + 1 prefetches to refill the stream.
+// Only the most-recently-used hitting buffer counts; a touched buffer
+// becomes MRU.
+
+class StreamPrefetcher {
+public:
+    StreamPrefetcher(uint32_t buffers, uint32_t blocks_per_buffer);
+
+    // Handle a demand access to 'block' given whether the cache hit.
+    // Returns true if the block was found in a stream buffer; 'issued'
+    // receives the number of prefetches generated.
+    bool access(uint32_t block, bool cache_hit, uint64_t& issued);
+
+    // One line per valid buffer, MRU first, each block number in hex.
+    void print_contents(std::ostream& os) const;
+
+    uint32_t buffers() const { return static_cast<uint32_t>(first_.size()); }
+    uint32_t depth()   const { return depth_; }
+
+private:
+    uint32_t              depth_;   // M
+    std::vector<uint32_t> first_;   // first block held by each buffer
+    std::vector<uint8_t>  valid_;
+    std::vector<uint32_t> order_;   // buffer indices, MRU first
+
+    void make_mru_(std::size_t pos);
+};
+
+#endif // PREFETCH_H
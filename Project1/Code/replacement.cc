@@ -0,0 +1,97 @@
+/***********************************************************************************
+ * File:        replacement.cc
+ * Author:      Connor Savugot
+ * Created:     2025-09-21
+ * Updated:     2025-09-21
+ * Version:     1.0
+ *
+ * Description: Replacement policy names/validation and per-policy metadata
+ *              initialization for the non-LRU policies in replacement.h.
+ ***********************************************************************************/
+
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "replacement.h"
+
+static const struct { ReplPolicy policy; const char* name; } kPolicyNames[] = {
+    { ReplPolicy::Lru,   "lru"   },
+    { ReplPolicy::Plru,  "plru"  },
+    { ReplPolicy::Nru,   "nru"   },
+    { ReplPolicy::Srrip, "srrip" },
+    { ReplPolicy::Brrip, "brrip" },
+    { ReplPolicy::Drrip, "drrip" },
+};
+
+const char* repl_policy_name(ReplPolicy p) {
+    for (const auto& e : kPolicyNames) if (e.policy == p) return e.name;
+    return "?";
+}
+
+bool parse_repl_policy(const char* s, ReplPolicy& out) {
+    std::string lower(s);
+    for (char& c : lower) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    for (const auto& e : kPolicyNames) {
+        if (lower == e.name) { out = e.policy; return true; }
+    }
+    return false;
+}
+
+bool validate_repl(ReplPolicy p, std::size_t assoc, std::string& err) {
+    if (p == ReplPolicy::Plru && (assoc == 0 || (assoc & (assoc - 1)) != 0)) {
+        err = "tree-PLRU needs a power-of-two associativity";
+        return false;
+    }
+    return true;
+}
+
+bool repl_is_per_set(ReplPolicy p) {
+    // BRRIP's throttle and DRRIP's PSEL are shared by all sets.
+    return p != ReplPolicy::Brrip && p != ReplPolicy::Drrip;
+}
+
+void ReplState::init(ReplPolicy p, std::size_t sets, std::size_t ways) {
+    assoc      = static_cast<uint32_t>(ways);
+    brrip_tick = 0;
+    psel       = (kPselMax + 1) / 2;
+
+    switch (p) {
+    case ReplPolicy::Lru:
+        meta.clear();
+        break;
+    case ReplPolicy::Plru:
+        meta.assign(sets * ways, 0);
+        break;
+    case ReplPolicy::Nru:
+        meta.assign(sets * ways, 1);
+        break;
+    case ReplPolicy::Srrip:
+    case ReplPolicy::Brrip:
+    case ReplPolicy::Drrip:
+        meta.assign(sets * ways, kRrpvMax);
+        break;
+    }
+
+    // DRRIP constituencies: kDuelLeaders of them when there are enough sets,
+    // otherwise every pair of sets duels. A single set has no leaders.
+    duel_region = 0;
+    if (p == ReplPolicy::Drrip && sets >= 2) {
+        const std::size_t region = sets / kDuelLeaders;
+        duel_region = static_cast<uint32_t>(region >= 2 ? region : 2);
+    }
+}
+
+uint32_t ReplState::rank(ReplPolicy p, uint64_t set, uint32_t way) const {
+    switch (p) {
+    case ReplPolicy::Nru:
+    case ReplPolicy::Srrip:
+    case ReplPolicy::Brrip:
+    case ReplPolicy::Drrip:
+        return set_meta(set)[way];
+    default:
+        return 0;   // PLRU has no total order; print in way order
+    }
+}
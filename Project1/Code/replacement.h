@@ -0,0 +1,179 @@
+#ifndef REPLACEMENT_H
+#define REPLACEMENT_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Replacement policies for Cache. Each policy is a stateless type whose
+// static members operate on a ReplState; Cache instantiates its access path
+// once per policy (Cache::access_with_<Policy>), so the policy updates inline
+// into the hot loop and the only runtime dispatch is one switch per access.
+//
+// Invalid ways are always filled first (Cache handles that); victim() is only
+// asked to pick among a full set. True LRU keeps its O(1) recency list inside
+// Cache, so LruRepl is just a tag type.
+
+enum class ReplPolicy { Lru, Plru, Nru, Srrip, Brrip, Drrip };
+
+const char* repl_policy_name(ReplPolicy p);
+
+// Parse "lru", "plru", "nru", "srrip", "brrip" or "drrip" (case-insensitive).
+bool parse_repl_policy(const char* s, ReplPolicy& out);
+
+// Check that 'p' can manage a set of 'assoc' ways (tree-PLRU needs a power
+// of two). On failure, 'err' says why.
+bool validate_repl(ReplPolicy p, std::size_t assoc, std::string& err);
+
+// True if the policy has no state shared between sets, so per-set simulation
+// (see shard.h) gives the same result as a serial run.
+bool repl_is_per_set(ReplPolicy p);
+
+// Metadata for the non-LRU policies: one byte per line, laid out like the tag
+// store (set * assoc + way). Tree-PLRU uses entries 1..assoc-1 of each set as
+// heap-ordered tree nodes; NRU keeps one "not recently used" bit; the RRIP
+// family keeps a 2-bit re-reference prediction value (RRPV).
+struct ReplState {
+    static constexpr uint8_t  kRrpvMax    = 3;      // 2-bit RRPV: 3 = distant
+    static constexpr uint32_t kBrripLong  = 32;     // BRRIP: 1 in 32 fills is "long"
+    static constexpr uint32_t kDuelLeaders = 32;    // DRRIP leader sets per policy
+    static constexpr uint32_t kPselMax    = 1023;   // DRRIP: 10-bit saturating PSEL
+
+    uint32_t             assoc = 0;
+    std::vector<uint8_t> meta;
+
+    uint32_t brrip_tick   = 0;                  // BRRIP bimodal throttle
+    uint32_t psel         = (kPselMax + 1) / 2; // DRRIP policy selector
+    uint32_t duel_region  = 0;                  // DRRIP: sets per constituency (0 = no leaders)
+
+    void init(ReplPolicy p, std::size_t sets, std::size_t assoc);
+
+    uint8_t* set_meta(uint64_t set) { return &meta[static_cast<std::size_t>(set) * assoc]; }
+    const uint8_t* set_meta(uint64_t set) const { return &meta[static_cast<std::size_t>(set) * assoc]; }
+
+    // Print rank of a line within its set for contents dumps: lower values
+    // are more protected (printed first).
+    uint32_t rank(ReplPolicy p, uint64_t set, uint32_t way) const;
+};
+
+// ---- Policies ----
+
+struct LruRepl {};   // true LRU: Cache's recency list (or age counters)
+
+// Tree pseudo-LRU: assoc-1 direction bits per set. Each node bit points to
+// the half that holds the pseudo-LRU way; an access flips the path away from
+// the accessed way.
+struct PlruRepl {
+    static void touch(ReplState& r, uint64_t set, uint32_t way) {
+        uint8_t* node = r.set_meta(set);
+        uint32_t n = 1;
+        for (uint32_t half = r.assoc >> 1; half; half >>= 1) {
+            const uint32_t right = (way & half) ? 1u : 0u;
+            node[n] = static_cast<uint8_t>(right ^ 1u);
+            n = 2 * n + right;
+        }
+    }
+    static void on_hit(ReplState& r, uint64_t set, uint32_t way)  { touch(r, set, way); }
+    static void on_fill(ReplState& r, uint64_t set, uint32_t way) { touch(r, set, way); }
+    static uint32_t victim(ReplState& r, uint64_t set) {
+        const uint8_t* node = r.set_meta(set);
+        uint32_t n = 1;
+        while (n < r.assoc) n = 2 * n + node[n];
+        return n - r.assoc;
+    }
+};
+
+// Not-recently-used: one bit per line, set = "not recently used". The victim
+// is the first such way; if there is none, every line is aged first.
+struct NruRepl {
+    static void on_hit(ReplState& r, uint64_t set, uint32_t way)  { r.set_meta(set)[way] = 0; }
+    static void on_fill(ReplState& r, uint64_t set, uint32_t way) { r.set_meta(set)[way] = 0; }
+    static uint32_t victim(ReplState& r, uint64_t set) {
+        uint8_t* m = r.set_meta(set);
+        for (uint32_t w = 0; w < r.assoc; ++w) if (m[w]) return w;
+        for (uint32_t w = 1; w < r.assoc; ++w) m[w] = 1;
+        return 0;
+    }
+};
+
+// Static RRIP (Jaleel et al., ISCA 2010) with hit-priority promotion.
+struct SrripRepl {
+    static void on_hit(ReplState& r, uint64_t set, uint32_t way) { r.set_meta(set)[way] = 0; }
+    static void on_fill(ReplState& r, uint64_t set, uint32_t way) {
+        r.set_meta(set)[way] = ReplState::kRrpvMax - 1;
+    }
+    // First way predicted "distant"; age the whole set until one is.
+    static uint32_t victim(ReplState& r, uint64_t set) {
+        uint8_t* m = r.set_meta(set);
+        uint8_t oldest = 0;
+        for (uint32_t w = 0; w < r.assoc; ++w) {
+            if (m[w] == ReplState::kRrpvMax) return w;
+            if (m[w] > oldest) oldest = m[w];
+        }
+        const uint8_t age = static_cast<uint8_t>(ReplState::kRrpvMax - oldest);
+        uint32_t v = 0;
+        bool found = false;
+        for (uint32_t w = 0; w < r.assoc; ++w) {
+            m[w] = static_cast<uint8_t>(m[w] + age);
+            if (!found && m[w] == ReplState::kRrpvMax) { v = w; found = true; }
+        }
+        return v;
+    }
+};
+
+// Bimodal RRIP: fills are predicted distant except for one in kBrripLong,
+// which makes the policy thrash-resistant. The throttle is a deterministic
+// counter so runs are reproducible.
+struct BrripRepl {
+    static void on_hit(ReplState& r, uint64_t set, uint32_t way) { SrripRepl::on_hit(r, set, way); }
+    static void on_fill(ReplState& r, uint64_t set, uint32_t way) {
+        if (++r.brrip_tick == ReplState::kBrripLong) {
+            r.brrip_tick = 0;
+            r.set_meta(set)[way] = ReplState::kRrpvMax - 1;
+        } else {
+            r.set_meta(set)[way] = ReplState::kRrpvMax;
+        }
+    }
+    static uint32_t victim(ReplState& r, uint64_t set) { return SrripRepl::victim(r, set); }
+};
+
+// Dynamic RRIP: set dueling between SRRIP and BRRIP. Each constituency of
+// duel_region sets has one SRRIP leader (first set) and one BRRIP leader
+// (last set); a miss in a leader moves PSEL towards the other policy and the
+// followers use whichever PSEL currently favors.
+struct DrripRepl {
+    enum Role { kFollower, kSrripLeader, kBrripLeader };
+
+    static Role role(const ReplState& r, uint64_t set) {
+        if (r.duel_region == 0) return kFollower;
+        const uint64_t off = set % r.duel_region;
+        if (off == 0)                 return kSrripLeader;
+        if (off == r.duel_region - 1) return kBrripLeader;
+        return kFollower;
+    }
+
+    static void on_hit(ReplState& r, uint64_t set, uint32_t way) { SrripRepl::on_hit(r, set, way); }
+    static void on_fill(ReplState& r, uint64_t set, uint32_t way) {
+        // Every fill is a miss in this set; leaders train PSEL.
+        bool use_brrip;
+        switch (role(r, set)) {
+        case kSrripLeader:
+            if (r.psel < ReplState::kPselMax) ++r.psel;
+            use_brrip = false;
+            break;
+        case kBrripLeader:
+            if (r.psel > 0) --r.psel;
+            use_brrip = true;
+            break;
+        default:
+            use_brrip = r.psel > ReplState::kPselMax / 2;
+            break;
+        }
+        if (use_brrip) BrripRepl::on_fill(r, set, way);
+        else           SrripRepl::on_fill(r, set, way);
+    }
+    static uint32_t victim(ReplState& r, uint64_t set) { return SrripRepl::victim(r, set); }
+};
+
+#endif // REPLACEMENT_H
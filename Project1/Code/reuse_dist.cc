@@ -0,0 +1,110 @@
+/***********************************************************************************
+ * File:        reuse_dist.cc
+ * Author:      Connor Savugot
+ * Created:     2025-09-21
+ * Updated:     2025-09-21
+ * Version:     1.0
+ *
+ * Description: Streaming log2-bucketed reuse-distance histogram over a
+ *              compacting Fenwick-tree timeline.
+ ***********************************************************************************/
+
+#include <cstdint>
+#include <cstddef>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "reuse_dist.h"
+
+static const uint32_t kMinTimeline = 1u << 16;
+
+ReuseHistogram::ReuseHistogram()
+: tree_(kMinTimeline, 0), owner_(kMinTimeline, 0), marked_(kMinTimeline, 0) {}
+
+void ReuseHistogram::add_(uint32_t pos, int32_t v) {
+    const uint32_t n = static_cast<uint32_t>(tree_.size());
+    for (uint32_t i = pos + 1; i <= n; i += i & (0u - i)) tree_[i - 1] += static_cast<uint32_t>(v);
+}
+
+uint32_t ReuseHistogram::prefix_(uint32_t pos) const {
+    uint32_t sum = 0;
+    for (uint32_t i = pos + 1; i > 0; i -= i & (0u - i)) sum += tree_[i - 1];
+    return sum;
+}
+
+void ReuseHistogram::compact_() {
+    // Renumber the live positions 0..live_-1 in timeline order, then size the
+    // timeline to twice the footprint (at least kMinTimeline) and rebuild.
+    std::size_t cap = kMinTimeline;
+    while (cap < 2 * static_cast<std::size_t>(live_) + 2) cap <<= 1;
+
+    std::vector<uint32_t> owner(cap, 0);
+    std::vector<uint8_t>  marked(cap, 0);
+    uint32_t j = 0;
+    for (uint32_t p = 0; p < next_; ++p) {
+        if (!marked_[p]) continue;
+        owner[j]  = owner_[p];
+        marked[j] = 1;
+        last_.exchange(owner_[p], j);
+        ++j;
+    }
+    owner_.swap(owner);
+    marked_.swap(marked);
+    next_ = j;
+
+    // O(n) Fenwick build: each node pushes its partial sum to its parent.
+    tree_.assign(cap, 0);
+    for (uint32_t p = 0; p < j; ++p) tree_[p] = 1;
+    for (uint32_t i = 1; i <= cap; ++i) {
+        const uint32_t parent = i + (i & (0u - i));
+        if (parent <= cap) tree_[parent - 1] += tree_[i - 1];
+    }
+}
+
+void ReuseHistogram::access(uint32_t block) {
+    if (next_ == tree_.size()) compact_();
+    const uint32_t pos  = next_++;
+    const uint32_t prev = last_.exchange(block, pos);
+    accesses_ += 1;
+
+    if (prev == BlockMap::kNone) {
+        cold_ += 1;
+        ++live_;
+    } else {
+        // Live positions after 'prev' are exactly the distinct blocks
+        // touched since then.
+        const uint32_t dist = live_ - prefix_(prev);
+        std::size_t k = 0;
+        for (uint32_t d = dist; d; d >>= 1) ++k;
+        hist_[k] += 1;
+        add_(prev, -1);
+        marked_[prev] = 0;
+    }
+    add_(pos, +1);
+    marked_[pos] = 1;
+    owner_[pos]  = block;
+}
+
+void ReuseHistogram::print(std::ostream& os, const char* title) const {
+    os << "===== " << title << " =====\n";
+    os << std::left << std::setw(24) << "distance" << std::right << std::setw(12) << "accesses"
+       << std::setw(10) << "%" << "\n";
+    auto row = [&](const std::string& label, uint64_t n) {
+        const double pct = accesses_ ? 100.0 * static_cast<double>(n) / static_cast<double>(accesses_) : 0.0;
+        os << std::left << std::setw(24) << label << std::right << std::setw(12) << n
+           << std::setw(10) << std::fixed << std::setprecision(2) << pct << "\n";
+        os << std::setprecision(6);
+        os.unsetf(std::ios::floatfield);
+    };
+    std::size_t last = 0;
+    for (std::size_t k = 0; k < kBuckets; ++k) if (hist_[k]) last = k;
+    for (std::size_t k = 0; k <= last; ++k) {
+        if (k == 0) { row("0", hist_[0]); continue; }
+        const uint64_t lo = 1ULL << (k - 1);
+        const uint64_t hi = (1ULL << k) - 1;
+        row(lo == hi ? std::to_string(lo) : std::to_string(lo) + "-" + std::to_string(hi), hist_[k]);
+    }
+    row("cold", cold_);
+}
@@ -0,0 +1,56 @@
+#ifndef REUSE_DIST_H
+#define REUSE_DIST_H
+
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+#include "block_map.h"
+
+// Streaming reuse-distance histogram for the block stream seen by one cache
+// level: for each access, the number of distinct blocks referenced since the
+// previous access to the same block (first references are "cold").
+//
+// Same Bennett-Kruskal scheme as the stack-distance pass: a Fenwick tree over
+// the access timeline marks each block's latest access, so a distance is one
+// O(log N) prefix count. The timeline is compacted (marked positions renumbered
+// in order) whenever it fills, so memory stays proportional to the footprint
+// rather than the trace length.
+//
+// Distances are bucketed by log2: bucket 0 holds distance 0 and bucket k > 0
+// holds [2^(k-1), 2^k).
+
+class ReuseHistogram {
+public:
+    static constexpr std::size_t kBuckets = 33;   // 0, [1,2) .. [2^31, 2^32)
+
+    ReuseHistogram();
+
+    void access(uint32_t block);
+
+    uint64_t bucket(std::size_t k) const { return hist_[k]; }
+    uint64_t cold() const { return cold_; }
+    uint64_t accesses() const { return accesses_; }
+
+    // Table of non-empty buckets plus the cold count, under a title line.
+    void print(std::ostream& os, const char* title) const;
+
+private:
+    BlockMap              last_;     // block -> timeline position of last use
+    std::vector<uint32_t> tree_;     // Fenwick tree over positions (1-based)
+    std::vector<uint32_t> owner_;    // position -> block, for compaction
+    std::vector<uint8_t>  marked_;   // position holds a block's latest use
+    uint32_t              next_   = 0;
+    uint32_t              live_   = 0;   // marked positions (= distinct blocks)
+
+    uint64_t hist_[kBuckets] = {};
+    uint64_t cold_     = 0;
+    uint64_t accesses_ = 0;
+
+    void     add_(uint32_t pos, int32_t v);
+    uint32_t prefix_(uint32_t pos) const;   // marked positions in [0, pos]
+    void     compact_();
+};
+
+#endif // REUSE_DIST_H
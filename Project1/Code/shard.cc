@@ -0,0 +1,66 @@
+/***********************************************************************************
+ * File:        shard.cc
+ * Author:      Connor Savugot
+ * Created:     2025-09-21
+ * Updated:     2025-09-21
+ * Version:     1.0
+ *
+ * Description: Set-sharded parallel L1 simulation: per-thread set ranges,
+ *              each fed its slice of the decoded trace, merged at the end.
+ ***********************************************************************************/
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+#include "shard.h"
+#include "thread_pool.h"
+
+bool can_shard(const Hierarchy& hier) {
+    // Stream buffers, write buffers, victim caches, the 3C shadow cache,
+    // reuse histograms and BRRIP/DRRIP state are shared across sets, so
+    // those configurations stay serial.
+    return hier.l2() == nullptr && hier.l1().num_sets() > 1 && !hier.l1().prefetcher() &&
+           !hier.l1().write_buffer() && !hier.l1().victim_cache() &&
+           !hier.l1().miss_classifier() && !hier.l1().reuse_histogram() &&
+           repl_is_per_set(hier.l1().config().repl);
+}
+
+void run_sharded(Hierarchy& hier, const DecodedTrace& trace, unsigned threads) {
+    const std::size_t sets   = hier.l1().num_sets();
+    const std::size_t shards = std::max<std::size_t>(1, std::min<std::size_t>(threads, sets));
+    const AddressMap  map    = hier.l1().address_map();
+
+    std::vector<std::unique_ptr<Hierarchy>> part(shards);
+    WorkStealingPool pool(static_cast<unsigned>(shards));
+    for (std::size_t k = 0; k < shards; ++k) {
+        const std::size_t lo = sets * k / shards;
+        const std::size_t hi = sets * (k + 1) / shards;
+        pool.submit([&, k, lo, hi] {
+            part[k] = std::make_unique<Hierarchy>(hier.spec());
+            // Compact this shard's records in order into a bounded buffer and
+            // run it through the (geometry-specialized) batch kernel.
+            const std::size_t cap = 1u << 16;
+            std::vector<uint32_t> addrs(cap);
+            std::vector<uint8_t>  writes(cap);
+            std::size_t n = 0;
+            for (std::size_t i = 0; i < trace.size(); ++i) {
+                const uint64_t set = map.index_of(trace.addrs[i]);
+                if (set < lo || set >= hi) continue;
+                addrs[n]  = trace.addrs[i];
+                writes[n] = trace.writes[i];
+                if (++n == cap) {
+                    part[k]->run_batch(addrs.data(), writes.data(), n);
+                    n = 0;
+                }
+            }
+            part[k]->run_batch(addrs.data(), writes.data(), n);
+        }, k);
+    }
+    pool.run();
+
+    for (std::size_t k = 0; k < shards; ++k) {
+        hier.l1().merge_sets_from(part[k]->l1(), sets * k / shards, sets * (k + 1) / shards);
+    }
+}
@@ -0,0 +1,25 @@
+#ifndef SHARD_H
+#define SHARD_H
+
+#include <cstddef>
+
+#include "hierarchy.h"
+#include "trace_stream.h"
+
+// Set-sharded parallel simulation of a single-level (L1-only) hierarchy.
+// Without a lower level, sets never interact, so the set index space is cut
+// into 'threads' contiguous ranges; each worker simulates, on a private copy
+// of the cache, only the trace records whose index_of(addr) falls in its
+// range (in trace order). The shards' sets and stats are then merged back
+// into 'hier', giving results bit-identical to a serial run.
+
+// True if 'hier' can be sharded (no L2 below L1, more than one set, no
+// stream-buffer prefetcher, write buffer, victim cache, miss classification
+// or reuse histogram, replacement state kept per set).
+bool can_shard(const Hierarchy& hier);
+
+// Simulate all of 'trace' into 'hier' using up to 'threads' shards.
+// Precondition: can_shard(hier).
+void run_sharded(Hierarchy& hier, const DecodedTrace& trace, unsigned threads);
+
+#endif // SHARD_H
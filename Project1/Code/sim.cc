@@ -15,6 +15,7 @@
 #include <inttypes.h>
 #include <cassert>
 #include <cmath>
+#include <cerrno>
 
 #include <cstdint>
 #include <memory>
@@ -23,37 +24,453 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <chrono>
+#include <cstring>
 
 #include "sim.h"
 #include "cache.h"
 #include "stats.h"
+#include "trace.h"
+#include "trace_stream.h"
+#include "cache_fixed.h"
+#include "hierarchy.h"
+#include "sweep.h"
+#include "thread_pool.h"
+#include "stackdist.h"
+#include "shard.h"
+#include "pipeline.h"
+#include "interval.h"
+#include "timing.h"
 
-// Return the final path component (no directories).
-static const char* basename_c(const char* path) {
-    if (!path) return "";
-    const char* s = path;
-    for (const char* p = path; *p; ++p) {
-        if (*p == '/' || *p == '\\') s = p + 1;
-    }
-    return s;
+// Parse a decimal count that fits in 32 bits: digits only, no sign, nothing
+// trailing. Returns false on anything else.
+static bool parse_u32(const char* s, uint32_t& out) {
+   if (*s < '0' || *s > '9') return false;
+   errno = 0;
+   char* end = nullptr;
+   const unsigned long long v = strtoull(s, &end, 10);
+   if (*end || errno == ERANGE || v > UINT32_MAX) return false;
+   out = (uint32_t) v;
+   return true;
+}
+
+// --threads=N|all: a positive count, or every hardware thread. Exits on
+// anything else.
+static unsigned parse_threads(const char* s) {
+   if (strcmp(s, "all") == 0) return WorkStealingPool::default_threads();
+   uint32_t n;
+   if (!parse_u32(s, n) || n == 0) {
+      printf("Error: Invalid thread count %s.\n", s);
+      exit(EXIT_FAILURE);
+   }
+   return n;
+}
+
+// Feed every trace record to 'access(op, addr)'. Exits on a malformed record.
+// Returns the number of records simulated.
+template <typename AccessFn>
+static std::size_t drive_trace(TraceReader* trace, CompressedTraceReader* ztrace,
+                               const char* trace_file, AccessFn access) {
+   std::size_t records = 0;
+   if (ztrace) {
+      // Batches arrive already decoded from the decompression thread.
+      TraceBatch batch;
+      while (ztrace->next_batch(batch)) {
+         const std::size_t n = batch.addrs.size();
+         for (std::size_t i = 0; i < n; ++i) {
+            access(batch.writes[i] ? Cache::Op::Write : Cache::Op::Read, batch.addrs[i]);
+         }
+         records += n;
+         if (batch.status == TraceReader::Status::BadOp) {
+            printf("Error: Unknown request type %c.\n", batch.bad_op);
+            exit(EXIT_FAILURE);
+         }
+      }
+      if (!ztrace->error().empty()) {
+         printf("Error: Failed reading %s (%s)\n", trace_file, ztrace->error().c_str());
+         exit(EXIT_FAILURE);
+      }
+   } else {
+      // Decoded in place from the mapped file.
+      Cache::Op op;
+      uint32_t addr;
+      char bad_op = 0;
+      TraceReader::Status st;
+      while ((st = trace->next(op, addr, bad_op)) == TraceReader::Status::Ok) {
+         access(op, addr);
+      }
+      if (st == TraceReader::Status::BadOp) {
+         printf("Error: Unknown request type %c.\n", bad_op);
+         exit(EXIT_FAILURE);
+      }
+      records = trace->records();
+   }
+   return records;
+}
+
+// Per-record hook for run_l1: nothing by default, IntervalRecorder with
+// --interval. A template parameter, so the default loop carries no check.
+struct NoTick { void operator()() {} };
+
+// Try the specialized kernel for one (BlockBytes, Assoc) pair.
+template <uint32_t BlockBytes, uint32_t Assoc, typename Tick>
+static bool try_fixed(Cache& l1, Cache* next_level, TraceReader* trace,
+                      CompressedTraceReader* ztrace, const char* trace_file,
+                      Tick& tick, std::size_t& records) {
+   if (!l1.has_fixed_kernel<BlockBytes, Assoc>()) return false;
+   records = drive_trace(trace, ztrace, trace_file, [&](Cache::Op op, uint32_t addr) {
+      l1.access_fixed<BlockBytes, Assoc>(op, addr, next_level);
+      tick();
+   });
+   return true;
+}
+
+template <uint32_t BlockBytes, typename Tick>
+static bool try_fixed_block(Cache& l1, Cache* next_level, TraceReader* trace,
+                            CompressedTraceReader* ztrace, const char* trace_file,
+                            Tick& tick, std::size_t& records) {
+   return try_fixed<BlockBytes, 1>(l1, next_level, trace, ztrace, trace_file, tick, records)
+       || try_fixed<BlockBytes, 2>(l1, next_level, trace, ztrace, trace_file, tick, records)
+       || try_fixed<BlockBytes, 4>(l1, next_level, trace, ztrace, trace_file, tick, records)
+       || try_fixed<BlockBytes, 8>(l1, next_level, trace, ztrace, trace_file, tick, records)
+       || try_fixed<BlockBytes, 16>(l1, next_level, trace, ztrace, trace_file, tick, records);
+}
+
+// Run the whole trace through L1: specialized geometry if available,
+// generic Cache::access otherwise (always, when built with -DCACHE_NO_FIXED).
+// 'tick' runs after every record.
+template <typename Tick>
+static std::size_t run_l1(Cache& l1, Cache* next_level, TraceReader* trace,
+                          CompressedTraceReader* ztrace, const char* trace_file, Tick& tick) {
+#ifndef CACHE_NO_FIXED
+   std::size_t records = 0;
+   if (try_fixed_block<16>(l1, next_level, trace, ztrace, trace_file, tick, records) ||
+       try_fixed_block<32>(l1, next_level, trace, ztrace, trace_file, tick, records) ||
+       try_fixed_block<64>(l1, next_level, trace, ztrace, trace_file, tick, records)) {
+      return records;
+   }
+#endif
+   return drive_trace(trace, ztrace, trace_file, [&](Cache::Op op, uint32_t addr) {
+      l1.access(op, addr, next_level);
+      tick();
+   });
+}
+
+// Open 'trace_file'. gzip traces are streamed through a background decoder;
+// otherwise the file is mapped and text or trace2bin binary is auto-detected.
+// Exits if the file cannot be read.
+static void open_trace(const char* trace_file, std::unique_ptr<TraceReader>& trace,
+                       std::unique_ptr<CompressedTraceReader>& ztrace) {
+   if (CompressedTraceReader::is_compressed(trace_file)) {
+      ztrace = std::make_unique<CompressedTraceReader>(trace_file);
+      if (!ztrace->is_open()) {
+         printf("Error: Unable to open file %s (%s)\n", trace_file, ztrace->error().c_str());
+         exit(EXIT_FAILURE);
+      }
+   } else {
+      trace = std::make_unique<TraceReader>(trace_file);
+      if (!trace->is_open()) {
+         if (trace->error()) printf("Error: Invalid trace file %s (%s)\n", trace_file, trace->error());
+         else                printf("Error: Unable to open file %s\n", trace_file);
+         exit(EXIT_FAILURE);
+      }
+   }
+}
+
+// --hier mode: a hierarchy of any depth from a file (see hierarchy.h),
+// simulated serially, and timed with --timing (see timing.h). Returns a
+// process exit status.
+static int run_hierarchy_file(const char* hier_file, char* trace_file, bool report_throughput,
+                              bool classify, bool reuse, bool timed, ReportFormat format) {
+   HierarchySpec spec;
+   std::string err;
+   if (!load_hierarchy_file(hier_file, spec, err)) {
+      printf("Error: %s: %s.\n", hier_file, err.c_str());
+      exit(EXIT_FAILURE);
+   }
+
+   std::unique_ptr<TraceReader>           trace;
+   std::unique_ptr<CompressedTraceReader> ztrace;
+   open_trace(trace_file, trace, ztrace);
+
+   Hierarchy hier(spec);
+   if (classify) hier.enable_miss_classification();
+   if (reuse)    hier.enable_reuse_histograms();
+
+   // Levels below L2 are reached through Cache::next_level().
+   NoTick no_tick;
+   std::unique_ptr<TimingModel> timing;
+   if (timed) timing = std::make_unique<TimingModel>(hier);
+   const auto t_start = std::chrono::steady_clock::now();
+   std::size_t records;
+   if (timing) {
+      records = drive_trace(trace.get(), ztrace.get(), trace_file, [&](Cache::Op op, uint32_t addr) {
+         timing->access(op, addr);
+      });
+   } else {
+      records = run_l1(hier.l1(), hier.l2(), trace.get(), ztrace.get(), trace_file, no_tick);
+   }
+   hier.drain_write_buffers();
+   const double secs = std::chrono::duration<double>(
+       std::chrono::steady_clock::now() - t_start).count();
+
+   if (report_throughput) {
+      fprintf(stderr, "trace: %zu records in %.6f s (%.0f records/s)\n",
+              records, secs, secs > 0 ? records / secs : 0.0);
+   }
+
+   RunInfo run;
+   run.trace_name = basename_c(trace_file);
+   run.records    = records;
+   run.wall_secs  = secs;
+   run.timing     = timing.get();
+   switch (format) {
+   case ReportFormat::Text:
+      hier.print_report(std::cout, run.trace_name);
+      if (timing) {
+         std::cout << "\n";
+         timing->print(std::cout);
+      }
+      break;
+   case ReportFormat::Json:
+      print_json_report(std::cout, hier.params(), hier.levels(), run);
+      break;
+   case ReportFormat::Csv:
+      print_csv_levels_header(std::cout);
+      print_csv_level_rows(std::cout, hier.params(), hier.levels(), run);
+      break;
+   }
+   return 0;
 }
 
 /*  Example:
     ./sim 32 8192 4 262144 8 3 10 gcc_trace.txt
+    ./sim 32 8192 4 262144 8 3 10 gcc_trace.txt --throughput
+    ./sim 32 8192 4 0 0 0 0 gcc_trace.txt --threads=all   (set-sharded, L1-only)
+    ./sim 32 8192 4 262144 8 0 0 gcc_trace.txt --pipeline (L1 and L2 on separate threads)
+    ./sim 32 8192 4 262144 8 0 0 gcc_trace.txt --interval=10000 --interval-out=phases.csv
+    ./sim 32 8192 4 65536 8 0 0 gcc_trace.txt --inclusion=exclusive
+    ./sim 32 8192 4 262144 8 0 0 gcc_trace.txt --l1-write=wtnwa --wbuf=8
+    ./sim 32 8192 1 262144 8 0 0 gcc_trace.txt --victim=8
+    ./sim 32 8192 4 262144 8 0 0 gcc_trace.txt --timing --latency=1,10 --mem-latency=100 --mshrs=8
+    ./sim --sweep configs.txt gcc_trace.txt          (see sweep.h)
+    ./sim --sweep configs.txt gcc_trace.txt --threads=all
+    ./sim --sweep configs.txt gcc_trace.txt --format=csv  (see stats.h)
+    ./sim --stackdist gcc_trace.txt --blocks=16,32 --max-sets=1024 --max-assoc=16
+    ./sim --hier hier_l3.txt gcc_trace.txt           (L1..Ln, see hierarchy.h)
 */
 int main (int argc, char *argv[]) {
-   FILE *fp;                 // File pointer.
    char *trace_file;         // Trace file name.
    cache_params_t params;    // See sim.h
-   char rw;                  // 'r' or 'w'
-   uint32_t addr;            // 32-bit address from trace
+   bool report_throughput = false;
+
+   // Stack-distance mode: miss counts for every associativity in one pass.
+   if (argc >= 2 && strcmp(argv[1], "--stackdist") == 0) {
+      if (argc < 3) {
+         printf("Usage: %s --stackdist TRACE_FILE [--blocks=B1,B2,..] [--max-sets=N] [--max-assoc=N] [--validate] [--throughput]\n", argv[0]);
+         exit(EXIT_FAILURE);
+      }
+      std::vector<uint32_t> blocks { 16, 32, 64 };
+      uint32_t max_sets = 4096, max_assoc = 16;
+      bool validate = false;
+      for (int i = 3; i < argc; ++i) {
+         if (strcmp(argv[i], "--throughput") == 0) report_throughput = true;
+         else if (strcmp(argv[i], "--validate") == 0) validate = true;
+         else if (strncmp(argv[i], "--max-sets=", 11) == 0) {
+            if (!parse_u32(argv[i] + 11, max_sets)) {
+               printf("Error: Invalid set count %s.\n", argv[i] + 11);
+               exit(EXIT_FAILURE);
+            }
+         }
+         else if (strncmp(argv[i], "--max-assoc=", 12) == 0) {
+            if (!parse_u32(argv[i] + 12, max_assoc)) {
+               printf("Error: Invalid associativity %s.\n", argv[i] + 12);
+               exit(EXIT_FAILURE);
+            }
+         }
+         else if (strncmp(argv[i], "--blocks=", 9) == 0) {
+            blocks.clear();
+            std::string list(argv[i] + 9);
+            std::size_t start = 0;
+            for (;;) {
+               const std::size_t comma = list.find(',', start);
+               const std::string item = list.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+               uint32_t b;
+               if (!parse_u32(item.c_str(), b)) {
+                  printf("Error: Invalid block size list %s.\n", argv[i] + 9);
+                  exit(EXIT_FAILURE);
+               }
+               blocks.push_back(b);
+               if (comma == std::string::npos) break;
+               start = comma + 1;
+            }
+         } else {
+            printf("Error: Unknown option %s.\n", argv[i]);
+            exit(EXIT_FAILURE);
+         }
+      }
+      for (uint32_t b : blocks) {
+         if (b == 0 || (b & (b - 1))) {
+            printf("Error: Block size %u is not a power of two.\n", b);
+            exit(EXIT_FAILURE);
+         }
+      }
+      if (max_assoc == 0 || max_sets == 0) {
+         printf("Error: --max-sets and --max-assoc must be positive.\n");
+         exit(EXIT_FAILURE);
+      }
+      if (max_sets > (1u << 31)) {
+         printf("Error: --max-sets must be at most 2147483648.\n");
+         exit(EXIT_FAILURE);
+      }
+      return run_stack_distance(argv[2], blocks, max_sets, max_assoc, validate, report_throughput);
+   }
 
-   // Expect exactly 8 command-line arguments (argc == 9 including program name).
-   if (argc != 9) {
+   // Hierarchy-file mode: any number of levels.
+   if (argc >= 2 && strcmp(argv[1], "--hier") == 0) {
+      if (argc < 4) {
+         printf("Usage: %s --hier HIERARCHY_FILE TRACE_FILE [--throughput] [--format=text|json|csv] [--3c] [--reuse] [--timing]\n", argv[0]);
+         exit(EXIT_FAILURE);
+      }
+      bool classify = false, reuse = false, timed = false;
+      ReportFormat format = ReportFormat::Text;
+      for (int i = 4; i < argc; ++i) {
+         if (strcmp(argv[i], "--throughput") == 0) report_throughput = true;
+         else if (strcmp(argv[i], "--3c") == 0) classify = true;
+         else if (strcmp(argv[i], "--reuse") == 0) reuse = true;
+         else if (strcmp(argv[i], "--timing") == 0) timed = true;
+         else if (strncmp(argv[i], "--format=", 9) == 0) {
+            if (!parse_report_format(argv[i] + 9, format)) {
+               printf("Error: Unknown report format %s.\n", argv[i] + 9);
+               exit(EXIT_FAILURE);
+            }
+         } else {
+            printf("Error: Unknown option %s.\n", argv[i]);
+            exit(EXIT_FAILURE);
+         }
+      }
+      return run_hierarchy_file(argv[2], argv[3], report_throughput, classify, reuse, timed, format);
+   }
+
+   // Sweep mode: many hierarchies, one pass over the trace.
+   if (argc >= 2 && strcmp(argv[1], "--sweep") == 0) {
+      if (argc < 4) {
+         printf("Usage: %s --sweep CONFIG_FILE TRACE_FILE [--threads=N|all] [--throughput] [--format=text|json|csv]\n", argv[0]);
+         exit(EXIT_FAILURE);
+      }
+      unsigned threads = 1;
+      ReportFormat format = ReportFormat::Text;
+      for (int i = 4; i < argc; ++i) {
+         if (strcmp(argv[i], "--throughput") == 0) report_throughput = true;
+         else if (strncmp(argv[i], "--format=", 9) == 0) {
+            if (!parse_report_format(argv[i] + 9, format)) {
+               printf("Error: Unknown report format %s.\n", argv[i] + 9);
+               exit(EXIT_FAILURE);
+            }
+         }
+         else if (strncmp(argv[i], "--threads=", 10) == 0) threads = parse_threads(argv[i] + 10);
+         else {
+            printf("Error: Unknown option %s.\n", argv[i]);
+            exit(EXIT_FAILURE);
+         }
+      }
+      return run_sweep(argv[2], argv[3], threads, report_throughput, format);
+   }
+
+   // Expect 8 positional arguments (argc == 9 including program name),
+   // optionally followed by flags.
+   if (argc < 9) {
       printf("Error: Expected 8 command-line arguments but was provided %d.\n", (argc - 1));
-      printf("Usage: %s BLOCKSIZE L1_SIZE L1_ASSOC L2_SIZE L2_ASSOC PREF_N PREF_M TRACE_FILE\n", argv[0]);
+      printf("Usage: %s BLOCKSIZE L1_SIZE L1_ASSOC L2_SIZE L2_ASSOC PREF_N PREF_M TRACE_FILE [--threads=N|all] [--pipeline] [--throughput]\n"
+             "          [--format=text|json|csv] [--3c] [--reuse] [--interval=K [--interval-out=FILE]] [--repl=P] [--l1-repl=P] [--l2-repl=P]   (P: lru plru nru srrip brrip drrip)\n"
+             "          [--inclusion=nine|inclusive|exclusive] [--write=W] [--l1-write=W] [--l2-write=W] [--wbuf=N] [--l2-wbuf=N]   (W: wbwa wbnwa wtwa wtnwa)\n"
+             "          [--victim=N] [--timing] [--latency=L1[,L2]] [--mem-latency=N] [--mshrs=N]   (cycles; 0 MSHRs: blocking L1)\n", argv[0]);
+      printf("       %s --sweep CONFIG_FILE TRACE_FILE [--threads=N|all] [--throughput] [--format=text|json|csv]\n", argv[0]);
+      printf("       %s --hier HIERARCHY_FILE TRACE_FILE [--throughput] [--format=text|json|csv] [--3c] [--reuse] [--timing]\n", argv[0]);
       exit(EXIT_FAILURE);
    }
+   unsigned threads = 1;
+   bool pipelined = false;
+   bool classify = false;
+   bool reuse = false;
+   uint64_t interval = 0;              // --interval=K: CSV row every K records
+   const char* interval_out = nullptr; // --interval-out=FILE (default stderr)
+   ReportFormat format = ReportFormat::Text;
+   ReplPolicy l1_repl = ReplPolicy::Lru;
+   ReplPolicy l2_repl = ReplPolicy::Lru;
+   Inclusion  inclusion = Inclusion::Nine;
+   WritePolicy l1_write = WritePolicy::WriteBackAllocate;
+   WritePolicy l2_write = WritePolicy::WriteBackAllocate;
+   uint32_t   l1_wbuf = 0, l2_wbuf = 0;   // write buffer entries
+   uint32_t   l1_victim = 0;              // victim cache entries
+   bool       timed = false;              // --timing and its parameters (see timing.h)
+   std::vector<uint32_t> latencies;       // hit latency per level, L1 first
+   int64_t    mem_latency = -1, mshrs = -1;   // -1: HierarchySpec default
+   for (int i = 9; i < argc; ++i) {
+      if (strncmp(argv[i], "--repl=", 7) == 0 || strncmp(argv[i], "--l1-repl=", 10) == 0 ||
+          strncmp(argv[i], "--l2-repl=", 10) == 0) {
+         const char* val = strchr(argv[i], '=') + 1;
+         ReplPolicy p;
+         if (!parse_repl_policy(val, p)) {
+            printf("Error: Unknown replacement policy %s.\n", val);
+            exit(EXIT_FAILURE);
+         }
+         if (argv[i][2] != 'l')      l1_repl = l2_repl = p;   // --repl=
+         else if (argv[i][3] == '1') l1_repl = p;
+         else                        l2_repl = p;
+      } else if (strncmp(argv[i], "--write=", 8) == 0 || strncmp(argv[i], "--l1-write=", 11) == 0 ||
+                 strncmp(argv[i], "--l2-write=", 11) == 0) {
+         const char* val = strchr(argv[i], '=') + 1;
+         WritePolicy w;
+         if (!parse_write_policy(val, w)) {
+            printf("Error: Unknown write policy %s.\n", val);
+            exit(EXIT_FAILURE);
+         }
+         if (argv[i][2] != 'l')      l1_write = l2_write = w;   // --write=
+         else if (argv[i][3] == '1') l1_write = w;
+         else                        l2_write = w;
+      } else if (strncmp(argv[i], "--wbuf=", 7) == 0) l1_wbuf = (uint32_t) atoi(argv[i] + 7);
+      else if (strncmp(argv[i], "--l2-wbuf=", 10) == 0) l2_wbuf = (uint32_t) atoi(argv[i] + 10);
+      else if (strncmp(argv[i], "--victim=", 9) == 0) l1_victim = (uint32_t) atoi(argv[i] + 9);
+      else if (strcmp(argv[i], "--timing") == 0) timed = true;
+      else if (strncmp(argv[i], "--latency=", 10) == 0) {
+         timed = true;
+         latencies.clear();
+         for (char* p = argv[i] + 10; *p; ) {
+            char* end = nullptr;
+            latencies.push_back((uint32_t) strtoul(p, &end, 10));
+            if (end == p || (*end && *end != ',')) {
+               printf("Error: Invalid latency list %s.\n", argv[i] + 10);
+               exit(EXIT_FAILURE);
+            }
+            p = *end ? end + 1 : end;
+         }
+      }
+      else if (strncmp(argv[i], "--mem-latency=", 14) == 0) { timed = true; mem_latency = atoi(argv[i] + 14); }
+      else if (strncmp(argv[i], "--mshrs=", 8) == 0) { timed = true; mshrs = atoi(argv[i] + 8); }
+      else if (strncmp(argv[i], "--inclusion=", 12) == 0) {
+         if (!parse_inclusion(argv[i] + 12, inclusion)) {
+            printf("Error: Unknown inclusion policy %s.\n", argv[i] + 12);
+            exit(EXIT_FAILURE);
+         }
+      } else if (strcmp(argv[i], "--throughput") == 0) report_throughput = true;
+      else if (strcmp(argv[i], "--pipeline") == 0) pipelined = true;
+      else if (strcmp(argv[i], "--3c") == 0) classify = true;
+      else if (strcmp(argv[i], "--reuse") == 0) reuse = true;
+      else if (strncmp(argv[i], "--interval=", 11) == 0) interval = strtoull(argv[i] + 11, nullptr, 10);
+      else if (strncmp(argv[i], "--interval-out=", 15) == 0) interval_out = argv[i] + 15;
+      else if (strncmp(argv[i], "--format=", 9) == 0) {
+         if (!parse_report_format(argv[i] + 9, format)) {
+            printf("Error: Unknown report format %s.\n", argv[i] + 9);
+            exit(EXIT_FAILURE);
+         }
+      }
+      else if (strncmp(argv[i], "--threads=", 10) == 0) threads = parse_threads(argv[i] + 10);
+      else {
+         printf("Error: Unknown option %s.\n", argv[i]);
+         exit(EXIT_FAILURE);
+      }
+   }
 
    // Parse CLI
    params.BLOCKSIZE = (uint32_t) atoi(argv[1]);
@@ -61,71 +478,161 @@ int main (int argc, char *argv[]) {
    params.L1_ASSOC  = (uint32_t) atoi(argv[3]);
    params.L2_SIZE   = (uint32_t) atoi(argv[4]);
    params.L2_ASSOC  = (uint32_t) atoi(argv[5]);
-   params.PREF_N    = (uint32_t) atoi(argv[6]);  // ECE463: parse but not used
-   params.PREF_M    = (uint32_t) atoi(argv[7]);  // ECE463: parse but not used
+   params.PREF_N    = (uint32_t) atoi(argv[6]);
+   params.PREF_M    = (uint32_t) atoi(argv[7]);
    trace_file       = argv[8];
 
-   // Open trace
-   fp = fopen(trace_file, "r");
-   if (fp == (FILE *) NULL) {
-      printf("Error: Unable to open file %s\n", trace_file);
+   // Open trace (see open_trace).
+   std::unique_ptr<TraceReader>           trace;
+   std::unique_ptr<CompressedTraceReader> ztrace;
+   open_trace(trace_file, trace, ztrace);
+
+   // Build cache hierarchy (stream buffers on the last level if PREF_N/PREF_M > 0;
+   // LRU, NINE and WBWA unless --repl/--inclusion/--write and friends chose
+   // other policies)
+   HierarchySpec spec = hierarchy_spec(params, l1_repl, l2_repl);
+   spec.levels[0].write        = l1_write;
+   spec.levels[0].write_buffer = l1_wbuf;
+   spec.levels[0].victim_cache = l1_victim;
+   for (std::size_t i = 0; i < latencies.size() && i < spec.levels.size(); ++i) {
+      spec.levels[i].hit_latency = latencies[i];
+   }
+   if (mshrs >= 0) {
+      // 0 makes L1 blocking; a lower level still tracks the one miss it serves.
+      spec.levels[0].mshrs = (uint32_t) mshrs;
+      for (std::size_t i = 1; i < spec.levels.size(); ++i) spec.levels[i].mshrs = mshrs ? (uint32_t) mshrs : 1;
+   }
+   if (mem_latency >= 0) spec.mem_latency = (uint32_t) mem_latency;
+   if (spec.levels.size() > 1) {
+      spec.levels[1].inclusion    = inclusion;
+      spec.levels[1].write        = l2_write;
+      spec.levels[1].write_buffer = l2_wbuf;
+   } else if (inclusion != Inclusion::Nine || l2_wbuf) {
+      printf("Error: --inclusion and --l2-wbuf need an L2.\n");
       exit(EXIT_FAILURE);
    }
+   {
+      std::string err;
+      if (!validate_hierarchy_spec(spec, err)) {
+         printf("Error: %s.\n", err.c_str());
+         exit(EXIT_FAILURE);
+      }
+   }
+   Hierarchy hier(spec);
+   if (classify) hier.enable_miss_classification();
+   if (reuse)    hier.enable_reuse_histograms();
+   Cache& l1 = hier.l1();
 
    // Print simulator configuration (trace file printed as basename only).
-   printf("===== Simulator configuration =====\n");
-   printf("BLOCKSIZE:  %u\n", params.BLOCKSIZE);
-   printf("L1_SIZE:    %u\n", params.L1_SIZE);
-   printf("L1_ASSOC:   %u\n", params.L1_ASSOC);
-   printf("L2_SIZE:    %u\n", params.L2_SIZE);
-   printf("L2_ASSOC:   %u\n", params.L2_ASSOC);
-   printf("PREF_N:     %u\n", params.PREF_N);
-   printf("PREF_M:     %u\n", params.PREF_M);
-   printf("trace_file: %s\n\n", basename_c(trace_file));
-
-   // Build cache hierarchy (ECE463: no prefetch logic)
-   CacheConfig l1_cfg {
-       "L1",
-       (std::size_t)params.L1_SIZE,
-       (std::size_t)params.L1_ASSOC,
-       (std::size_t)params.BLOCKSIZE
-   };
-   Cache l1(l1_cfg);
-
-   const bool has_l2 = (params.L2_SIZE > 0 && params.L2_ASSOC > 0);
-   std::unique_ptr<Cache> l2;
-   if (has_l2) {
-       CacheConfig l2_cfg {
-           "L2",
-           (std::size_t)params.L2_SIZE,
-           (std::size_t)params.L2_ASSOC,
-           (std::size_t)params.BLOCKSIZE
-       };
-       l2 = std::make_unique<Cache>(l2_cfg);
-   }
-
-   // Read requests from the trace.
-   // NOTE: Leading space before %c skips whitespace/newlines between lines.
-   while (fscanf(fp, " %c %x", &rw, &addr) == 2) {
-      Cache::Op op;
-      if (rw == 'r' || rw == 'R')      op = Cache::Op::Read;
-      else if (rw == 'w' || rw == 'W') op = Cache::Op::Write;
-      else {
-         printf("Error: Unknown request type %c.\n", rw);
-         fclose(fp);
+   if (format == ReportFormat::Text) {
+      print_sim_config(std::cout, params, basename_c(trace_file), &l1, hier.l2());
+   }
+
+   // Read requests from the trace, through a geometry-specialized L1 kernel
+   // when one matches the CLI parameters (see cache_fixed.h).
+   // With --threads, an L1-only hierarchy is instead split by set index
+   // across threads (see shard.h); two-level runs stay serial.
+   Cache* next_level = hier.l2();
+   // Interval snapshots read L1/L2 counters between records, so they need
+   // the serial path.
+   // The timing model follows every record in order, so it is serial too.
+   const bool sharded = (threads > 1 && can_shard(hier) && interval == 0 && !timed);
+   if (threads > 1 && !sharded) {
+      fprintf(stderr, "note: --threads ignored (set sharding needs an L1-only config with > 1 set, no prefetcher, write buffer, victim cache, --3c, --reuse, --interval or --timing, per-set replacement)\n");
+   }
+   if (pipelined && next_level && timed) {
+      fprintf(stderr, "note: --pipeline ignored (--timing needs the serial path)\n");
+      pipelined = false;
+   }
+   if (pipelined && next_level && interval) {
+      fprintf(stderr, "note: --pipeline ignored (--interval needs the serial path)\n");
+      pipelined = false;
+   }
+   if (pipelined && next_level && hier.has_inclusion_policy()) {
+      fprintf(stderr, "note: --pipeline ignored (--inclusion needs the serial path)\n");
+      pipelined = false;
+   }
+   std::unique_ptr<IntervalRecorder> intervals;
+   if (interval) {
+      intervals = std::make_unique<IntervalRecorder>(interval, interval_out, l1, next_level);
+      if (!intervals->is_open()) {
+         printf("Error: Unable to open interval output %s\n", interval_out);
          exit(EXIT_FAILURE);
       }
-
-      l1.access(op, (uint32_t)addr, has_l2 ? l2.get() : nullptr);
    }
+   NoTick no_tick;
+   std::unique_ptr<TimingModel> timing;
+   if (timed) timing = std::make_unique<TimingModel>(hier);
+   const auto t_start = std::chrono::steady_clock::now();
+   std::size_t records = 0;
+   if (timing) {
+      records = drive_trace(trace.get(), ztrace.get(), trace_file, [&](Cache::Op op, uint32_t addr) {
+         timing->access(op, addr);
+         if (intervals) (*intervals)();
+      });
+      hier.drain_write_buffers();
+      if (intervals) intervals->finish();
+   } else if (sharded) {
+      DecodedTrace decoded;
+      std::string err;
+      trace.reset();
+      ztrace.reset();
+      if (!load_decoded_trace(trace_file, decoded, err)) {
+         printf("Error: Failed reading %s (%s)\n", trace_file, err.c_str());
+         exit(EXIT_FAILURE);
+      }
+      run_sharded(hier, decoded, threads);
+      records = decoded.size();
+   } else if (pipelined && next_level) {
+      // L1 on this thread; its misses/writebacks stream to an L2 thread.
+      L2Pipeline pipe(l1, *next_level);
+      records = run_l1(l1, next_level, trace.get(), ztrace.get(), trace_file, no_tick);
+      l1.drain_write_buffer();   // into the ring, before it closes
+      pipe.finish();
+      hier.drain_write_buffers();
+   } else if (intervals) {
+      if (pipelined) fprintf(stderr, "note: --pipeline ignored (no L2)\n");
+      records = run_l1(l1, next_level, trace.get(), ztrace.get(), trace_file, *intervals);
+      hier.drain_write_buffers();
+      intervals->finish();
+   } else {
+      if (pipelined) fprintf(stderr, "note: --pipeline ignored (no L2)\n");
+      records = run_l1(l1, next_level, trace.get(), ztrace.get(), trace_file, no_tick);
+      hier.drain_write_buffers();
+   }
+   const double secs = std::chrono::duration<double>(
+       std::chrono::steady_clock::now() - t_start).count();
 
-   fclose(fp);
+   if (report_throughput) {
+      fprintf(stderr, "trace: %zu records in %.6f s (%.0f records/s)\n",
+              records, secs, secs > 0 ? records / secs : 0.0);
+   }
 
    // Final reporting (format aligns with provided validation files)
    AllStats totals;
    totals.l1 = l1.stats();
-   if (has_l2) totals.l2 = l2->stats();
+   if (hier.l2()) totals.l2 = hier.l2()->stats();
 
-   print_final_report(std::cout, l1, has_l2 ? l2.get() : nullptr, totals);
+   RunInfo run;
+   run.trace_name = basename_c(trace_file);
+   run.records    = records;
+   run.wall_secs  = secs;
+   run.timing     = timing.get();
+   switch (format) {
+   case ReportFormat::Text:
+      print_final_report(std::cout, l1, hier.l2(), totals);
+      if (timing) {
+         std::cout << "\n";
+         timing->print(std::cout);
+      }
+      break;
+   case ReportFormat::Json:
+      print_json_report(std::cout, params, l1, hier.l2(), totals, run);
+      break;
+   case ReportFormat::Csv:
+      print_csv_header(std::cout);
+      print_csv_row(std::cout, params, l1, hier.l2(), totals, run);
+      break;
+   }
    return 0;
 }
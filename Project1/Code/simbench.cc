@@ -0,0 +1,150 @@
+/***********************************************************************************
+ * File:        simbench.cc
+ * Author:      Connor Savugot
+ * Created:     2025-09-21
+ * Updated:     2025-09-21
+ * Version:     1.0
+ *
+ * Description: Throughput benchmark for the simulator hot path. Runs decoded
+ *              traces through Hierarchy::run_batch (the same fixed/generic
+ *              Cache::access kernels ./sim uses) for a matrix of geometries
+ *              and reports accesses/sec, ns/access with run-to-run spread,
+ *              and peak RSS per configuration.
+ ***********************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "sim.h"
+#include "hierarchy.h"
+#include "stats.h"
+#include "trace_stream.h"
+
+// Geometries covering each kernel family: direct-mapped and low-assoc fixed
+// kernels, an L1+L2 hierarchy, a wide SIMD-matched set, a prefetching L2 and
+// a fully-associative (hash-indexed) cache.
+static const cache_params_t kMatrix[] = {
+    //  BLOCK   L1_SIZE  L1_ASSOC  L2_SIZE  L2_ASSOC  PREF_N  PREF_M
+    {    16,     1024,      1,         0,       0,      0,      0 },
+    {    32,     8192,      4,         0,       0,      0,      0 },
+    {    32,     8192,      4,    262144,       8,      0,      0 },
+    {    32,    65536,     16,         0,       0,      0,      0 },
+    {    32,     8192,      4,    262144,       8,      3,      4 },
+    {    32,     4096,    128,         0,       0,      0,      0 },
+};
+
+// Each run's miss count is stored here so the compiler cannot drop the run.
+static volatile uint64_t bench_sink;
+
+struct BenchRow {
+    double mean_ns = 0, stddev_ns = 0, min_ns = 0;
+    double accesses_per_sec = 0;
+};
+
+// 'reps' fresh hierarchies, each fed the trace 'passes' times. Timing
+// covers run_batch only (trace decoding happens once, before).
+static BenchRow bench_config(const cache_params_t& p, const DecodedTrace& trace,
+                             unsigned passes, unsigned reps) {
+    std::vector<double> ns(reps);
+    const double accesses = static_cast<double>(trace.size()) * passes;
+    for (unsigned r = 0; r < reps; ++r) {
+        Hierarchy hier(p);
+        const auto t0 = std::chrono::steady_clock::now();
+        for (unsigned k = 0; k < passes; ++k) {
+            hier.run_batch(trace.addrs.data(), trace.writes.data(), trace.size());
+        }
+        const double secs = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - t0).count();
+        ns[r] = accesses > 0 ? secs * 1e9 / accesses : 0.0;
+        bench_sink = hier.l1().stats().read_misses + hier.l1().stats().write_misses;
+    }
+
+    BenchRow row;
+    double sum = 0, sq = 0;
+    row.min_ns = ns[0];
+    for (double v : ns) { sum += v; if (v < row.min_ns) row.min_ns = v; }
+    row.mean_ns = sum / reps;
+    for (double v : ns) sq += (v - row.mean_ns) * (v - row.mean_ns);
+    row.stddev_ns = reps > 1 ? std::sqrt(sq / (reps - 1)) : 0.0;
+    row.accesses_per_sec = row.mean_ns > 0 ? 1e9 / row.mean_ns : 0.0;
+    return row;
+}
+
+/*  Example:
+    ./simbench traces/gcc_trace.txt traces/go_trace.txt
+    ./simbench --reps=10 --min-accesses=5000000 traces/vortex_trace.txt
+    Each (trace, config) runs in a forked child so its peak RSS is its own.
+*/
+int main (int argc, char *argv[]) {
+   unsigned reps = 5;
+   uint64_t min_accesses = 2000000;
+   std::vector<const char*> traces;
+   for (int i = 1; i < argc; ++i) {
+      if (strncmp(argv[i], "--reps=", 7) == 0)              reps = (unsigned) atoi(argv[i] + 7);
+      else if (strncmp(argv[i], "--min-accesses=", 15) == 0) min_accesses = strtoull(argv[i] + 15, nullptr, 10);
+      else if (argv[i][0] == '-') {
+         printf("Error: Unknown option %s.\n", argv[i]);
+         exit(EXIT_FAILURE);
+      }
+      else traces.push_back(argv[i]);
+   }
+   if (traces.empty() || reps == 0) {
+      printf("Usage: %s [--reps=N] [--min-accesses=N] TRACE_FILE...\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   printf("%-20s %-30s %5s %10s %10s %8s %8s %10s\n",
+          "trace", "config", "reps", "Macc/s", "ns/acc", "stddev", "min", "peakRSS");
+   fflush(stdout);
+
+   int failures = 0;
+   for (const char* path : traces) {
+      for (const cache_params_t& p : kMatrix) {
+         const pid_t pid = fork();
+         if (pid < 0) { perror("fork"); exit(EXIT_FAILURE); }
+         if (pid == 0) {
+            DecodedTrace trace;
+            std::string err;
+            if (!load_decoded_trace(path, trace, err)) {
+               printf("Error: Failed reading %s (%s)\n", path, err.c_str());
+               fflush(stdout);
+               _exit(EXIT_FAILURE);
+            }
+            const uint64_t n = trace.size() ? trace.size() : 1;
+            const unsigned passes = (unsigned) ((min_accesses + n - 1) / n);
+            const BenchRow row = bench_config(p, trace, passes ? passes : 1, reps);
+
+            char cfg[64];
+            snprintf(cfg, sizeof(cfg), "%u %u %u %u %u %u %u", p.BLOCKSIZE, p.L1_SIZE,
+                     p.L1_ASSOC, p.L2_SIZE, p.L2_ASSOC, p.PREF_N, p.PREF_M);
+            printf("%-20s %-30s %5u %10.2f %10.3f %8.3f %8.3f ",
+                   basename_c(path), cfg, reps, row.accesses_per_sec / 1e6,
+                   row.mean_ns, row.stddev_ns, row.min_ns);
+            fflush(stdout);
+            _exit(EXIT_SUCCESS);
+         }
+
+         int status = 0;
+         struct rusage ru;
+         if (wait4(pid, &status, 0, &ru) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            printf("\n");
+            ++failures;
+            continue;
+         }
+         printf("%8ld KiB\n", ru.ru_maxrss);   // Linux reports KiB
+         fflush(stdout);
+      }
+   }
+   return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
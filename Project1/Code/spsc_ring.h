@@ -0,0 +1,79 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Lock-free single-producer / single-consumer ring. The producer only writes
+// tail_, the consumer only writes head_; each side keeps a cached copy of the
+// other's index so the shared cache lines are touched only when the ring looks
+// full (producer) or empty (consumer). Waiting spins briefly, then yields, so
+// it still behaves when both threads share one core.
+
+template <typename T>
+class SpscRing {
+public:
+    // 'capacity' is rounded up to a power of two.
+    explicit SpscRing(std::size_t capacity) {
+        std::size_t cap = 2;
+        while (cap < capacity) cap <<= 1;
+        buf_.resize(cap);
+        mask_ = cap - 1;
+    }
+
+    // Producer: blocks (spin, then yield) while full.
+    void push(const T& v) {
+        const std::size_t t = tail_.load(std::memory_order_relaxed);
+        unsigned spins = 0;
+        while (t - head_cache_ > mask_) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (t - head_cache_ > mask_) backoff_(spins);
+        }
+        buf_[t & mask_] = v;
+        tail_.store(t + 1, std::memory_order_release);
+    }
+
+    // Producer: no more pushes.
+    void close() { closed_.store(true, std::memory_order_release); }
+
+    // Consumer: move up to 'max' items into 'out'. Blocks while empty; returns
+    // 0 only once the ring is closed and drained.
+    std::size_t pop_bulk(T* out, std::size_t max) {
+        const std::size_t h = head_.load(std::memory_order_relaxed);
+        unsigned spins = 0;
+        while (tail_cache_ == h) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (tail_cache_ != h) break;
+            if (closed_.load(std::memory_order_acquire)) {
+                tail_cache_ = tail_.load(std::memory_order_acquire);
+                if (tail_cache_ == h) return 0;
+                break;
+            }
+            backoff_(spins);
+        }
+        std::size_t n = tail_cache_ - h;
+        if (n > max) n = max;
+        for (std::size_t i = 0; i < n; ++i) out[i] = buf_[(h + i) & mask_];
+        head_.store(h + n, std::memory_order_release);
+        return n;
+    }
+
+private:
+    static void backoff_(unsigned& spins) {
+        if (++spins < 64) return;
+        std::this_thread::yield();
+    }
+
+    std::vector<T> buf_;
+    std::size_t    mask_ = 0;
+
+    alignas(64) std::atomic<std::size_t> tail_ { 0 };   // written by producer
+    std::size_t                          head_cache_ = 0;
+    alignas(64) std::atomic<std::size_t> head_ { 0 };   // written by consumer
+    std::size_t                          tail_cache_ = 0;
+    alignas(64) std::atomic<bool>        closed_ { false };
+};
+
+#endif // SPSC_RING_H
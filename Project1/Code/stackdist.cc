@@ -0,0 +1,169 @@
+/***********************************************************************************
+ * File:        stackdist.cc
+ * Author:      Connor Savugot
+ * Created:     2025-09-21
+ * Updated:     2025-09-21
+ * Version:     1.0
+ *
+ * Description: One-pass LRU stack-distance (Mattson) analysis producing miss
+ *              counts for every associativity of a block size / set count,
+ *              plus a cross-check against direct Cache simulation.
+ ***********************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "stackdist.h"
+#include "cache.h"
+#include "block_map.h"
+
+uint64_t StackDistResult::read_misses(uint32_t assoc) const {
+    uint64_t m = 0;
+    for (uint32_t d = assoc; d <= max_assoc; ++d) m += read_hist[d];
+    return m;
+}
+
+uint64_t StackDistResult::write_misses(uint32_t assoc) const {
+    uint64_t m = 0;
+    for (uint32_t d = assoc; d <= max_assoc; ++d) m += write_hist[d];
+    return m;
+}
+
+StackDistResult stack_distance(const DecodedTrace& trace, uint32_t block_bytes,
+                               uint32_t sets, uint32_t max_assoc) {
+    StackDistResult r;
+    r.block_bytes = block_bytes;
+    r.sets        = sets;
+    r.max_assoc   = max_assoc;
+    r.read_hist.assign(max_assoc + 1, 0);
+    r.write_hist.assign(max_assoc + 1, 0);
+
+    const AddressMap map = AddressMap::make(block_bytes, sets);
+    const std::size_t n = trace.size();
+
+    // Lay every set's timeline out in one buffer: set s owns positions
+    // [base[s], base[s] + count[s]), each with its own Fenwick tree.
+    std::vector<uint32_t> base(sets + 1, 0);
+    for (std::size_t i = 0; i < n; ++i) base[map.index_of(trace.addrs[i]) + 1] += 1;
+    for (uint32_t s = 0; s < sets; ++s) base[s + 1] += base[s];
+    std::vector<uint32_t> next_pos(base.begin(), base.end() - 1);
+    std::vector<int32_t>  fenwick(n + 1, 0);   // 1-based within each set
+
+    auto add = [&](uint32_t set, uint32_t local, int32_t v) {
+        const uint32_t len = base[set + 1] - base[set];
+        int32_t* tree = &fenwick[base[set]];
+        for (uint32_t i = local + 1; i <= len; i += i & (0u - i)) tree[i - 1] += v;
+    };
+    auto prefix = [&](uint32_t set, uint32_t local) -> int64_t {   // sum over [0, local]
+        const int32_t* tree = &fenwick[base[set]];
+        int64_t sum = 0;
+        for (uint32_t i = local + 1; i > 0; i -= i & (0u - i)) sum += tree[i - 1];
+        return sum;
+    };
+
+    BlockMap last;   // block -> last access position
+    for (std::size_t i = 0; i < n; ++i) {
+        const uint32_t addr  = trace.addrs[i];
+        const bool     write = trace.writes[i] != 0;
+        const uint32_t set   = static_cast<uint32_t>(map.index_of(addr));
+        const uint32_t pos   = next_pos[set]++;
+        const uint32_t local = pos - base[set];
+
+        uint32_t dist = max_assoc;   // cold
+        const uint32_t prev = last.exchange(map.block_of(addr), pos);
+        if (prev != BlockMap::kNone) {
+            const uint32_t prev_local = prev - base[set];
+            // Distinct blocks touched strictly between the two uses.
+            const int64_t between = (local ? prefix(set, local - 1) : 0) - prefix(set, prev_local);
+            dist = between < max_assoc ? static_cast<uint32_t>(between) : max_assoc;
+            add(set, prev_local, -1);
+        }
+        add(set, local, +1);
+
+        if (write) { r.writes += 1; r.write_hist[dist] += 1; }
+        else       { r.reads  += 1; r.read_hist[dist]  += 1; }
+    }
+    return r;
+}
+
+void print_stack_distance_header(std::ostream& os) {
+    os << "BLOCKSIZE SETS ASSOC SIZE READ_MISSES WRITE_MISSES MISS_RATE\n";
+}
+
+void print_stack_distance(std::ostream& os, const StackDistResult& r) {
+    const uint64_t total = r.reads + r.writes;
+    for (uint32_t a = 1; a <= r.max_assoc; ++a) {
+        const uint64_t rm = r.read_misses(a);
+        const uint64_t wm = r.write_misses(a);
+        os << r.block_bytes << " " << r.sets << " " << a << " "
+           << static_cast<uint64_t>(r.block_bytes) * r.sets * a << " "
+           << rm << " " << wm << " "
+           << std::fixed << std::setprecision(4)
+           << (total ? static_cast<double>(rm + wm) / static_cast<double>(total) : 0.0)
+           << std::setprecision(6) << "\n";
+    }
+}
+
+std::size_t validate_stack_distance(std::ostream& os, const DecodedTrace& trace,
+                                    const StackDistResult& r) {
+    std::size_t bad = 0;
+    for (uint32_t a = 1; a <= r.max_assoc; a *= 2) {
+        CacheConfig cfg { "L1", static_cast<std::size_t>(r.block_bytes) * r.sets * a, a, r.block_bytes };
+        Cache c(cfg);
+        for (std::size_t i = 0; i < trace.size(); ++i) {
+            c.access(trace.writes[i] ? Cache::Op::Write : Cache::Op::Read, trace.addrs[i], nullptr);
+        }
+        const AccessStats& st = c.stats();
+        if (st.read_misses != r.read_misses(a) || st.write_misses != r.write_misses(a)) {
+            os << "validate: MISMATCH block " << r.block_bytes << " sets " << r.sets
+               << " assoc " << a << ": cache " << st.read_misses << "/" << st.write_misses
+               << " stackdist " << r.read_misses(a) << "/" << r.write_misses(a) << "\n";
+            ++bad;
+        }
+    }
+    return bad;
+}
+
+int run_stack_distance(const char* trace_file, const std::vector<uint32_t>& blocks,
+                       uint32_t max_sets, uint32_t max_assoc, bool validate,
+                       bool report_throughput) {
+    std::string err;
+    DecodedTrace trace;
+    if (!load_decoded_trace(trace_file, trace, err)) {
+        printf("Error: Failed reading %s (%s)\n", trace_file, err.c_str());
+        return EXIT_FAILURE;
+    }
+
+    std::size_t bad = 0, passes = 0;
+    const auto t_start = std::chrono::steady_clock::now();
+    print_stack_distance_header(std::cout);
+    for (uint32_t b : blocks) {
+        // 64-bit so the doubling cannot wrap before passing max_sets.
+        for (uint64_t s = 1; s <= max_sets; s *= 2) {
+            const StackDistResult r = stack_distance(trace, b, static_cast<uint32_t>(s), max_assoc);
+            print_stack_distance(std::cout, r);
+            if (validate) bad += validate_stack_distance(std::cerr, trace, r);
+            ++passes;
+        }
+    }
+    const double secs = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - t_start).count();
+
+    if (report_throughput) {
+        fprintf(stderr, "stackdist: %zu passes x %zu records in %.6f s (%zu cache sizes)\n",
+                passes, trace.size(), secs, passes * max_assoc);
+    }
+    if (validate) {
+        fprintf(stderr, "validate: %s (%zu mismatching points)\n", bad ? "FAILED" : "ok", bad);
+        if (bad) return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
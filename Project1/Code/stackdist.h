@@ -0,0 +1,60 @@
+#ifndef STACKDIST_H
+#define STACKDIST_H
+
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+#include "trace_stream.h"
+
+// Mattson LRU stack-distance analysis. For one (block size, set count)
+// geometry, a single pass over the trace yields the per-set LRU stack
+// distance of every access; by LRU inclusion, an access hits in an A-way
+// cache of that geometry iff its distance is < A. So one pass gives the
+// exact read/write miss counts of every associativity (and hence every
+// size = sets * assoc * block) at once, matching an L1-only Cache run.
+//
+// Distances use the Bennett-Kruskal method: a Fenwick tree over each set's
+// access timeline marks the latest access of every block, so the number of
+// distinct blocks touched since the previous use is an O(log N) range count.
+
+struct StackDistResult {
+    uint32_t block_bytes = 0;
+    uint32_t sets        = 0;
+    uint32_t max_assoc   = 0;
+    uint64_t reads       = 0;
+    uint64_t writes      = 0;
+    // read_hist[d] / write_hist[d]: accesses at stack distance d (d < max_assoc);
+    // index max_assoc collects distance >= max_assoc and first-touch (cold).
+    std::vector<uint64_t> read_hist;
+    std::vector<uint64_t> write_hist;
+
+    // Misses of a cache with this geometry and 'assoc' ways (assoc <= max_assoc).
+    uint64_t read_misses(uint32_t assoc) const;
+    uint64_t write_misses(uint32_t assoc) const;
+};
+
+// One pass over 'trace' for the given geometry.
+StackDistResult stack_distance(const DecodedTrace& trace, uint32_t block_bytes,
+                               uint32_t sets, uint32_t max_assoc);
+
+// Table header and one row per assoc in [1, max_assoc]:
+// BLOCKSIZE SETS ASSOC SIZE READ_MISSES WRITE_MISSES MISS_RATE
+void print_stack_distance_header(std::ostream& os);
+void print_stack_distance(std::ostream& os, const StackDistResult& r);
+
+// Cross-check against real L1-only Cache runs for assoc 1, 2, 4, ... up to
+// max_assoc. Returns the number of mismatching points (details to 'os').
+std::size_t validate_stack_distance(std::ostream& os, const DecodedTrace& trace,
+                                    const StackDistResult& r);
+
+// --stackdist mode: decode the trace once, then one pass per (block size,
+// set count) for every block in 'blocks' and sets = 1, 2, 4, ... max_sets,
+// printing the table above. With 'validate', each pass is cross-checked
+// against Cache runs. Returns a process exit status.
+int run_stack_distance(const char* trace_file, const std::vector<uint32_t>& blocks,
+                       uint32_t max_sets, uint32_t max_assoc, bool validate,
+                       bool report_throughput);
+
+#endif // STACKDIST_H
@@ -13,6 +13,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <inttypes.h>
 #include <cassert>
 #include <cmath>
@@ -27,12 +28,155 @@
 
 #include "stats.h"
 #include "cache.h"
+#include "timing.h"
 
 static double safe_rate(uint64_t miss, uint64_t total) {
     if (total == 0) return 0.0;
     return static_cast<double>(miss) / static_cast<double>(total);
 }
 
+const char* basename_c(const char* path) {
+    if (!path) return "";
+    const char* s = path;
+    for (const char* p = path; *p; ++p) {
+        if (*p == '/' || *p == '\\') s = p + 1;
+    }
+    return s;
+}
+
+void print_sim_config(std::ostream& os, const cache_params_t& params, const char* trace_name,
+                      const Cache* l1, const Cache* l2)
+{
+    os << "===== Simulator configuration =====\n";
+    os << "BLOCKSIZE:  " << params.BLOCKSIZE << "\n";
+    os << "L1_SIZE:    " << params.L1_SIZE   << "\n";
+    os << "L1_ASSOC:   " << params.L1_ASSOC  << "\n";
+    os << "L2_SIZE:    " << params.L2_SIZE   << "\n";
+    os << "L2_ASSOC:   " << params.L2_ASSOC  << "\n";
+    os << "PREF_N:     " << params.PREF_N    << "\n";
+    os << "PREF_M:     " << params.PREF_M    << "\n";
+    if (l1) {
+        const CacheConfig& c1 = l1->config();
+        const CacheConfig* c2 = l2 ? &l2->config() : nullptr;
+        if (c1.repl != ReplPolicy::Lru || (c2 && c2->repl != ReplPolicy::Lru)) {
+            os << "L1_REPL:    " << repl_policy_name(c1.repl) << "\n";
+            if (c2) os << "L2_REPL:    " << repl_policy_name(c2->repl) << "\n";
+        }
+        if (c2 && c2->inclusion != Inclusion::Nine) {
+            os << "INCLUSION:  " << inclusion_name(c2->inclusion) << "\n";
+        }
+        if (c1.write != WritePolicy::WriteBackAllocate || (c2 && c2->write != WritePolicy::WriteBackAllocate)) {
+            os << "L1_WRITE:   " << write_policy_name(c1.write) << "\n";
+            if (c2) os << "L2_WRITE:   " << write_policy_name(c2->write) << "\n";
+        }
+        const uint32_t wb1 = l1->write_buffer() ? l1->write_buffer()->capacity() : 0;
+        const uint32_t wb2 = l2 && l2->write_buffer() ? l2->write_buffer()->capacity() : 0;
+        if (wb1 || wb2) {
+            os << "L1_WBUF:    " << wb1 << "\n";
+            if (l2) os << "L2_WBUF:    " << wb2 << "\n";
+        }
+        if (l1->victim_cache()) os << "L1_VICTIM:  " << l1->victim_cache()->capacity() << "\n";
+    }
+    os << "trace_file: " << trace_name       << "\n\n";
+}
+
+// Optional victim-cache, write-policy and inclusion counters (levels with
+// non-default policies), three-C breakdown (--3c) and reuse-distance
+// histograms (--reuse), one block/table per level; absent from the
+// reference format.
+static void print_analysis_sections(std::ostream& os, const Cache* const* levels, std::size_t n) {
+    const int label_w = 32;
+    auto print_wide = [&](const std::string& label, uint64_t v) {
+        os << label << ' ' << std::setw(std::max(0, label_w - (int)label.size())) << v << "\n";
+    };
+    bool any_victim = false;
+    for (std::size_t i = 0; i < n; ++i) any_victim |= levels[i]->victim_cache() != nullptr;
+    if (any_victim) {
+        os << "\n===== Victim cache =====\n";
+        for (std::size_t i = 0; i < n; ++i) {
+            const Cache& c = *levels[i];
+            if (!c.victim_cache()) continue;
+            const std::string& name = c.config().name;
+            const AccessStats& st = c.stats();
+            print_wide(name + " victim cache probes:", st.victim_probes);
+            print_wide(name + " victim cache hits:",   st.victim_hits);
+            const std::string rate = name + " victim cache hit rate:";
+            const std::ios::fmtflags flags = os.flags();
+            os << rate << ' ' << std::setw(std::max(0, label_w - (int)rate.size()))
+               << std::fixed << std::setprecision(4) << safe_rate(st.victim_hits, st.victim_probes) << "\n";
+            os.flags(flags);
+            os << std::setprecision(6);
+            // Every hit is a block not fetched from the level below. Writebacks
+            // deferred by parking dirty lines here show in the level's
+            // writeback count, not in this line.
+            print_wide(name + " fetches saved:", st.victim_hits);
+
+            std::vector<uint32_t> blocks;
+            std::vector<bool>     dirty;
+            c.victim_cache()->contents(blocks, dirty);
+            os << name << " victim cache contents:";
+            for (std::size_t k = 0; k < blocks.size(); ++k) {
+                os << ' ' << std::hex << (blocks[k] >> c.address_map().off_bits) << std::dec
+                   << (dirty[k] ? " D" : "");
+            }
+            os << "\n";
+        }
+    }
+    bool any_write = false;
+    for (std::size_t i = 0; i < n; ++i) {
+        any_write |= levels[i]->config().write != WritePolicy::WriteBackAllocate || levels[i]->write_buffer();
+    }
+    if (any_write) {
+        os << "\n===== Write policy =====\n";
+        for (std::size_t i = 0; i < n; ++i) {
+            const Cache& c = *levels[i];
+            if (c.config().write == WritePolicy::WriteBackAllocate && !c.write_buffer()) continue;
+            const std::string& name = c.config().name;
+            print_wide(name + " write-throughs:", c.stats().write_throughs);
+            if (c.write_buffer()) print_wide(name + " write buffer coalesced:", c.stats().wbuf_coalesced);
+        }
+    }
+    bool any_inclusion = false;
+    for (std::size_t i = 1; i < n; ++i) any_inclusion |= levels[i]->config().inclusion != Inclusion::Nine;
+    if (any_inclusion) {
+        os << "\n===== Inclusion =====\n";
+        for (std::size_t i = 1; i < n; ++i) {
+            const CacheConfig& cfg = levels[i]->config();
+            std::string label = cfg.name + " " + inclusion_name(cfg.inclusion);
+            uint64_t v;
+            if (cfg.inclusion == Inclusion::Inclusive) {
+                label += " back-invalidations:";
+                v = levels[i]->stats().back_invalidations;
+            } else if (cfg.inclusion == Inclusion::Exclusive) {
+                label += " victim fills:";
+                v = levels[i]->stats().victim_fills;
+            } else {
+                continue;
+            }
+            print_wide(label, v);
+        }
+    }
+    if (levels[0]->miss_classifier()) {
+        os << "\n===== Miss classification (3C) =====\n";
+        auto print_count = [&](const std::string& label, uint64_t v) {
+            os << label << std::setw(std::max(1, label_w - 1 - (int)label.size())) << v << "\n";
+        };
+        for (std::size_t i = 0; i < n; ++i) {
+            if (!levels[i]->miss_classifier()) continue;
+            const std::string& name = levels[i]->config().name;
+            const MissClassStats& m = levels[i]->miss_classifier()->stats();
+            print_count(name + " compulsory misses:", m.compulsory);
+            print_count(name + " capacity misses:",   m.capacity);
+            print_count(name + " conflict misses:",   m.conflict);
+        }
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        if (!levels[i]->reuse_histogram()) continue;
+        os << "\n";
+        levels[i]->reuse_histogram()->print(os, (levels[i]->config().name + " reuse distance").c_str());
+    }
+}
+
 void print_final_report(std::ostream& os,
                         const Cache& l1,
                         const Cache* l2_opt,
@@ -49,6 +193,14 @@ void print_final_report(std::ostream& os,
         l2_opt->print_contents(os);
     }
 
+    // Stream buffers belong to the last-level cache.
+    const Cache& last = l2_opt ? *l2_opt : l1;
+    if (last.prefetcher()) {
+        os << "\n";
+        os << "===== Stream Buffer(s) contents =====\n";
+        last.prefetcher()->print_contents(os);
+    }
+
     // Blank line between contents and Measurements (validator expects this)
     os << "\n";
 
@@ -69,18 +221,20 @@ void print_final_report(std::ostream& os,
     os << std::setprecision(6); // restore default precision
     os << "f. L1 writebacks:"             << std::setw(label_w - 16) << A.writebacks   << "\n";
 
-    // ECE463: no prefetching; still print L2/prefetch lines (zeros if unused)
-    uint64_t l2_reads_demand      = B.reads;        // demand fills only (no prefetch in 463)
-    uint64_t l2_read_miss_demand  = B.read_misses;  // demand read misses
+    // Only the last level prefetches; a/c and h/l count demand accesses, and
+    // the model has no prefetch requests reaching L2 from L1 (j/k stay 0).
+    uint64_t l1_prefetches        = l2_opt ? 0 : A.pref_issued;
+    uint64_t l2_reads_demand      = B.reads;
+    uint64_t l2_read_miss_demand  = B.read_misses;
     uint64_t l2_reads_prefetch    = 0;
     uint64_t l2_read_miss_pref    = 0;
     uint64_t l2_writes            = B.writes;
     uint64_t l2_write_misses      = B.write_misses;
     double   l2_miss_rate         = safe_rate(l2_read_miss_demand, l2_reads_demand); // demand-only
     uint64_t l2_writebacks        = B.writebacks;
-    uint64_t l2_prefetches        = 0;
+    uint64_t l2_prefetches        = B.pref_issued;
 
-    os << "g. L1 prefetches:"             << std::setw(label_w - 16) << 0                  << "\n";
+    os << "g. L1 prefetches:"             << std::setw(label_w - 16) << l1_prefetches      << "\n";
     os << "h. L2 reads (demand):"         << std::setw(label_w - 21) << l2_reads_demand    << "\n";
     os << "i. L2 read misses (demand):"   << std::setw(label_w - 28) << l2_read_miss_demand<< "\n";
     os << "j. L2 reads (prefetch):"       << std::setw(label_w - 23) << l2_reads_prefetch  << "\n";
@@ -93,7 +247,387 @@ void print_final_report(std::ostream& os,
     os << "o. L2 writebacks:"             << std::setw(label_w - 16) << l2_writebacks      << "\n";
     os << "p. L2 prefetches:"             << std::setw(label_w - 16) << l2_prefetches      << "\n";
 
-    const uint64_t mem_traffic =
-        (A.memory_reads + A.memory_writes + B.memory_reads + B.memory_writes);
+    const uint64_t mem_traffic = memory_traffic(totals);
     os << "q. memory traffic:"            << std::setw(label_w - 17) << mem_traffic        << "\n";
+
+    const Cache* levels[] = { &l1, l2_opt };
+    print_analysis_sections(os, levels, l2_opt ? 2 : 1);
+}
+
+uint64_t memory_traffic(const AllStats& totals) {
+    // Only the last level prefetches, so at most one pref_issued is non-zero.
+    const AccessStats& A = totals.l1;
+    const AccessStats& B = totals.l2;
+    return A.memory_reads + A.memory_writes + A.pref_issued +
+           B.memory_reads + B.memory_writes + B.pref_issued;
+}
+
+void print_levels_config(std::ostream& os, const cache_params_t& params,
+                         const std::vector<const Cache*>& levels, const char* trace_name)
+{
+    os << "===== Simulator configuration =====\n";
+    os << "BLOCKSIZE:  " << params.BLOCKSIZE << "\n";
+    for (const Cache* c : levels) {
+        const CacheConfig& cfg = c->config();
+        const std::string label = cfg.name + ":";
+        os << label << std::string(label.size() < 12 ? 12 - label.size() : 1, ' ')
+           << cfg.size_bytes << " B, " << cfg.assoc << "-way, "
+           << repl_policy_name(cfg.repl);
+        if (cfg.inclusion != Inclusion::Nine) os << ", " << inclusion_name(cfg.inclusion);
+        if (cfg.write != WritePolicy::WriteBackAllocate) os << ", " << write_policy_name(cfg.write);
+        if (c->write_buffer()) os << ", " << c->write_buffer()->capacity() << "-entry write buffer";
+        if (c->victim_cache()) os << ", " << c->victim_cache()->capacity() << "-entry victim cache";
+        os << "\n";
+    }
+    os << "PREF_N:     " << params.PREF_N    << "\n";
+    os << "PREF_M:     " << params.PREF_M    << "\n";
+    os << "trace_file: " << trace_name       << "\n\n";
+}
+
+uint64_t level_traffic(const Cache& c) {
+    const AccessStats& s = c.stats();
+    if (!c.next_level()) return s.memory_reads + s.memory_writes + s.pref_issued;
+    const Cache& next = *c.next_level();
+    const bool allocates = c.config().write == WritePolicy::WriteBackAllocate ||
+                           c.config().write == WritePolicy::WriteThroughAllocate;
+    const uint64_t fills = s.read_misses + (allocates ? s.write_misses : 0) - s.victim_hits;
+    const uint64_t evictions = next.config().inclusion == Inclusion::Exclusive
+                             ? next.stats().victim_fills : s.writebacks;
+    return fills + evictions + s.write_throughs - s.wbuf_coalesced + s.pref_issued;
+}
+
+// Line e for the first level, line n (demand reads) below it.
+static double level_miss_rate(const std::vector<const Cache*>& levels, std::size_t i) {
+    const AccessStats& s = levels[i]->stats();
+    if (i == 0) return safe_rate(s.read_misses + s.write_misses, s.reads + s.writes);
+    return safe_rate(s.read_misses, s.reads);
+}
+
+void print_final_report(std::ostream& os, const std::vector<const Cache*>& levels)
+{
+    if (levels.size() <= 2) {
+        const Cache* l2 = levels.size() > 1 ? levels[1] : nullptr;
+        AllStats totals;
+        totals.l1 = levels[0]->stats();
+        if (l2) totals.l2 = l2->stats();
+        print_final_report(os, *levels[0], l2, totals);
+        return;
+    }
+
+    // ----- Contents -----
+    for (std::size_t i = 0; i < levels.size(); ++i) {
+        if (i) os << "\n";
+        os << "===== " << levels[i]->config().name << " contents =====\n";
+        levels[i]->print_contents(os);
+    }
+    const Cache& last = *levels.back();
+    if (last.prefetcher()) {
+        os << "\n";
+        os << "===== Stream Buffer(s) contents =====\n";
+        last.prefetcher()->print_contents(os);
+    }
+    os << "\n";
+
+    // ----- Measurements (same value column as the reference report) -----
+    const int label_w = 32;
+    const std::ios::fmtflags flags = os.flags();
+    auto value_w = [&](const std::string& label) { return std::max(1, label_w + 1 - (int)label.size()); };
+    auto print_count = [&](const std::string& label, uint64_t v) {
+        os << label << std::setw(value_w(label)) << v << "\n";
+    };
+
+    os << "===== Measurements =====\n";
+    for (std::size_t i = 0; i < levels.size(); ++i) {
+        const std::string& name = levels[i]->config().name;
+        const AccessStats& st = levels[i]->stats();
+        if (i) os << "\n";
+        print_count(name + " reads:",        st.reads);
+        print_count(name + " read misses:",  st.read_misses);
+        print_count(name + " writes:",       st.writes);
+        print_count(name + " write misses:", st.write_misses);
+        const std::string rate = name + " miss rate:";
+        os << rate << std::setw(value_w(rate)) << std::fixed << std::setprecision(4)
+           << level_miss_rate(levels, i) << "\n";
+        os.flags(flags);
+        os << std::setprecision(6);
+        print_count(name + " writebacks:",   st.writebacks);
+        print_count(name + " prefetches:",   st.pref_issued);
+        print_count(i + 1 < levels.size()
+                        ? name + " traffic to " + levels[i + 1]->config().name + ":"
+                        : name + " memory traffic:",
+                    level_traffic(*levels[i]));
+    }
+
+    print_analysis_sections(os, levels.data(), levels.size());
+}
+
+// ---- Structured output ----
+
+static const struct { const char* name; uint64_t AccessStats::*field; } kStatFields[] = {
+    { "reads",         &AccessStats::reads         },
+    { "read_misses",   &AccessStats::read_misses   },
+    { "writes",        &AccessStats::writes        },
+    { "write_misses",  &AccessStats::write_misses  },
+    { "writebacks",    &AccessStats::writebacks    },
+    { "memory_reads",  &AccessStats::memory_reads  },
+    { "memory_writes", &AccessStats::memory_writes },
+    { "pref_issued",   &AccessStats::pref_issued   },
+    { "pref_useful",   &AccessStats::pref_useful   },
+    { "pref_late",     &AccessStats::pref_late     },
+    { "back_invalidations", &AccessStats::back_invalidations },
+    { "victim_fills",       &AccessStats::victim_fills       },
+    { "write_throughs",     &AccessStats::write_throughs     },
+    { "wbuf_coalesced",     &AccessStats::wbuf_coalesced     },
+    { "victim_probes",      &AccessStats::victim_probes      },
+    { "victim_hits",        &AccessStats::victim_hits        },
+};
+
+bool parse_report_format(const char* s, ReportFormat& out) {
+    if (strcmp(s, "text") == 0) { out = ReportFormat::Text; return true; }
+    if (strcmp(s, "json") == 0) { out = ReportFormat::Json; return true; }
+    if (strcmp(s, "csv")  == 0) { out = ReportFormat::Csv;  return true; }
+    return false;
+}
+
+// Miss rates as on report lines e and n (L2: demand reads only).
+static double l1_miss_rate(const AccessStats& A) {
+    return safe_rate(A.read_misses + A.write_misses, A.reads + A.writes);
+}
+static double l2_miss_rate(const AccessStats& B) {
+    return safe_rate(B.read_misses, B.reads);
+}
+
+static double accesses_per_sec(const RunInfo& run) {
+    return run.wall_secs > 0 ? static_cast<double>(run.records) / run.wall_secs : 0.0;
+}
+
+static void json_string(std::ostream& os, const char* s) {
+    os << '"';
+    for (const char* p = s; *p; ++p) {
+        const unsigned char c = static_cast<unsigned char>(*p);
+        if (c == '"' || c == '\\') os << '\\' << *p;
+        else if (c < 0x20) {
+            char buf[8];
+            snprintf(buf, sizeof(buf), "\\u%04x", c);
+            os << buf;
+        } else {
+            os << *p;
+        }
+    }
+    os << '"';
+}
+
+// ,"timing":{cycles, amat, memory latency, per-level latency and MSHRs},
+// when the run was timed.
+static void json_timing(std::ostream& os, const std::vector<const Cache*>& levels, const RunInfo& run) {
+    const TimingModel* t = run.timing;
+    if (!t) return;
+    os << ",\"timing\":{\"cycles\":" << t->cycles()
+       << ",\"amat\":" << t->amat()
+       << ",\"mem_latency\":" << t->mem_latency()
+       << ",\"levels\":[";
+    for (std::size_t i = 0; i < t->depth(); ++i) {
+        const TimingLevelStats& s = t->level_stats(i);
+        if (i) os << ',';
+        os << "{\"name\":";
+        json_string(os, levels[i]->config().name.c_str());
+        os << ",\"hit_latency\":" << t->hit_latency(i)
+           << ",\"mshrs\":" << t->mshrs(i)
+           << ",\"mshr_merges\":" << s.mshr_merges
+           << ",\"mshr_stall_cycles\":" << s.mshr_stall_cycles
+           << ",\"mshr_peak\":" << s.mshr_peak << '}';
+    }
+    os << "]}";
+}
+
+static uint32_t wbuf_entries(const Cache* c) {
+    return c && c->write_buffer() ? c->write_buffer()->capacity() : 0;
+}
+
+static uint32_t victim_entries(const Cache* c) {
+    return c && c->victim_cache() ? c->victim_cache()->capacity() : 0;
+}
+
+static void json_level(std::ostream& os, const AccessStats& st, double miss_rate) {
+    os << '{';
+    for (const auto& f : kStatFields) os << '"' << f.name << "\":" << st.*f.field << ',';
+    os << "\"miss_rate\":" << miss_rate << '}';
+}
+
+void print_json_report(std::ostream& os, const cache_params_t& params,
+                       const Cache& l1, const Cache* l2_opt,
+                       const AllStats& totals, const RunInfo& run) {
+    const std::ios::fmtflags flags = os.flags();
+    const std::streamsize    prec  = os.precision();
+    os << std::setprecision(10);
+
+    os << "{\"config\":{"
+       << "\"blocksize\":" << params.BLOCKSIZE
+       << ",\"l1_size\":"  << params.L1_SIZE
+       << ",\"l1_assoc\":" << params.L1_ASSOC
+       << ",\"l2_size\":"  << params.L2_SIZE
+       << ",\"l2_assoc\":" << params.L2_ASSOC
+       << ",\"pref_n\":"   << params.PREF_N
+       << ",\"pref_m\":"   << params.PREF_M
+       << ",\"l1_repl\":\"" << repl_policy_name(l1.config().repl) << '"'
+       << ",\"l2_repl\":\"" << repl_policy_name(l2_opt ? l2_opt->config().repl : ReplPolicy::Lru) << '"'
+       << ",\"inclusion\":\"" << inclusion_name(l2_opt ? l2_opt->config().inclusion : Inclusion::Nine) << '"'
+       << ",\"l1_write\":\"" << write_policy_name(l1.config().write) << '"'
+       << ",\"l2_write\":\"" << write_policy_name(l2_opt ? l2_opt->config().write : WritePolicy::WriteBackAllocate) << '"'
+       << ",\"l1_wbuf\":" << wbuf_entries(&l1)
+       << ",\"l2_wbuf\":" << wbuf_entries(l2_opt)
+       << ",\"l1_victim\":" << victim_entries(&l1)
+       << ",\"trace_file\":";
+    json_string(os, run.trace_name);
+    os << "},\"l1\":";
+    json_level(os, totals.l1, l1_miss_rate(totals.l1));
+    os << ",\"l2\":";
+    json_level(os, totals.l2, l2_miss_rate(totals.l2));
+    os << ",\"memory_traffic\":" << memory_traffic(totals);
+
+    auto json_3c = [&](const char* key, const Cache* c) {
+        if (!c || !c->miss_classifier()) return;
+        const MissClassStats& m = c->miss_classifier()->stats();
+        os << ",\"" << key << "\":{\"compulsory\":" << m.compulsory
+           << ",\"capacity\":" << m.capacity << ",\"conflict\":" << m.conflict << '}';
+    };
+    json_3c("l1_3c", &l1);
+    json_3c("l2_3c", l2_opt);
+    std::vector<const Cache*> levels { &l1 };
+    if (l2_opt) levels.push_back(l2_opt);
+    json_timing(os, levels, run);
+
+    os << ",\"throughput\":{\"records\":" << run.records
+       << ",\"wall_seconds\":" << run.wall_secs
+       << ",\"accesses_per_sec\":" << accesses_per_sec(run) << "}}\n";
+
+    os.flags(flags);
+    os.precision(prec);
+}
+
+// Strings (trace and level names) are quoted only when they would break the row.
+static void csv_string(std::ostream& os, const std::string& s) {
+    if (s.find_first_of(",\"\n") != std::string::npos) {
+        os << '"';
+        for (char c : s) {
+            if (c == '"') os << '"';
+            os << c;
+        }
+        os << '"';
+    } else {
+        os << s;
+    }
+}
+
+void print_csv_header(std::ostream& os) {
+    os << "trace_file,blocksize,l1_size,l1_assoc,l2_size,l2_assoc,pref_n,pref_m,l1_repl,l2_repl,inclusion,l1_write,l2_write,l1_wbuf,l2_wbuf,l1_victim";
+    for (const char* level : { "l1", "l2" }) {
+        for (const auto& f : kStatFields) os << ',' << level << '_' << f.name;
+        os << ',' << level << "_miss_rate";
+    }
+    os << ",memory_traffic,records,wall_seconds,accesses_per_sec\n";
+}
+
+void print_csv_row(std::ostream& os, const cache_params_t& params,
+                   const Cache& l1, const Cache* l2_opt,
+                   const AllStats& totals, const RunInfo& run) {
+    const std::ios::fmtflags flags = os.flags();
+    const std::streamsize    prec  = os.precision();
+    os << std::setprecision(10);
+
+    csv_string(os, run.trace_name);
+    os << ',' << params.BLOCKSIZE << ',' << params.L1_SIZE << ',' << params.L1_ASSOC
+       << ',' << params.L2_SIZE << ',' << params.L2_ASSOC << ',' << params.PREF_N
+       << ',' << params.PREF_M << ',' << repl_policy_name(l1.config().repl)
+       << ',' << repl_policy_name(l2_opt ? l2_opt->config().repl : ReplPolicy::Lru)
+       << ',' << inclusion_name(l2_opt ? l2_opt->config().inclusion : Inclusion::Nine)
+       << ',' << write_policy_name(l1.config().write)
+       << ',' << write_policy_name(l2_opt ? l2_opt->config().write : WritePolicy::WriteBackAllocate)
+       << ',' << wbuf_entries(&l1) << ',' << wbuf_entries(l2_opt) << ',' << victim_entries(&l1);
+    for (const auto& f : kStatFields) os << ',' << totals.l1.*f.field;
+    os << ',' << l1_miss_rate(totals.l1);
+    for (const auto& f : kStatFields) os << ',' << totals.l2.*f.field;
+    os << ',' << l2_miss_rate(totals.l2);
+    os << ',' << memory_traffic(totals) << ',' << run.records << ',' << run.wall_secs
+       << ',' << accesses_per_sec(run) << "\n";
+
+    os.flags(flags);
+    os.precision(prec);
+}
+
+void print_json_report(std::ostream& os, const cache_params_t& params,
+                       const std::vector<const Cache*>& levels, const RunInfo& run) {
+    const std::ios::fmtflags flags = os.flags();
+    const std::streamsize    prec  = os.precision();
+    os << std::setprecision(10);
+
+    os << "{\"config\":{"
+       << "\"blocksize\":" << params.BLOCKSIZE
+       << ",\"pref_n\":"   << params.PREF_N
+       << ",\"pref_m\":"   << params.PREF_M
+       << ",\"trace_file\":";
+    json_string(os, run.trace_name);
+    os << "},\"levels\":[";
+    for (std::size_t i = 0; i < levels.size(); ++i) {
+        const Cache& c = *levels[i];
+        const AccessStats& st = c.stats();
+        if (i) os << ',';
+        os << "{\"name\":";
+        json_string(os, c.config().name.c_str());
+        os << ",\"size\":" << c.config().size_bytes
+           << ",\"assoc\":" << c.config().assoc
+           << ",\"repl\":\"" << repl_policy_name(c.config().repl) << '"'
+           << ",\"inclusion\":\"" << inclusion_name(c.config().inclusion) << '"'
+           << ",\"write\":\"" << write_policy_name(c.config().write) << '"'
+           << ",\"wbuf\":" << wbuf_entries(&c)
+           << ",\"victim\":" << victim_entries(&c);
+        for (const auto& f : kStatFields) os << ",\"" << f.name << "\":" << st.*f.field;
+        os << ",\"miss_rate\":" << level_miss_rate(levels, i)
+           << ",\"traffic\":" << level_traffic(c);
+        if (c.miss_classifier()) {
+            const MissClassStats& m = c.miss_classifier()->stats();
+            os << ",\"3c\":{\"compulsory\":" << m.compulsory
+               << ",\"capacity\":" << m.capacity << ",\"conflict\":" << m.conflict << '}';
+        }
+        os << '}';
+    }
+    os << "],\"memory_traffic\":" << level_traffic(*levels.back());
+    json_timing(os, levels, run);
+
+    os << ",\"throughput\":{\"records\":" << run.records
+       << ",\"wall_seconds\":" << run.wall_secs
+       << ",\"accesses_per_sec\":" << accesses_per_sec(run) << "}}\n";
+
+    os.flags(flags);
+    os.precision(prec);
+}
+
+void print_csv_levels_header(std::ostream& os) {
+    os << "trace_file,blocksize,pref_n,pref_m,level,size,assoc,repl,inclusion,write,wbuf,victim";
+    for (const auto& f : kStatFields) os << ',' << f.name;
+    os << ",miss_rate,traffic,records,wall_seconds,accesses_per_sec\n";
+}
+
+void print_csv_level_rows(std::ostream& os, const cache_params_t& params,
+                          const std::vector<const Cache*>& levels, const RunInfo& run) {
+    const std::ios::fmtflags flags = os.flags();
+    const std::streamsize    prec  = os.precision();
+    os << std::setprecision(10);
+
+    for (std::size_t i = 0; i < levels.size(); ++i) {
+        const Cache& c = *levels[i];
+        csv_string(os, run.trace_name);
+        os << ',' << params.BLOCKSIZE << ',' << params.PREF_N << ',' << params.PREF_M << ',';
+        csv_string(os, c.config().name);
+        os << ',' << c.config().size_bytes << ',' << c.config().assoc
+           << ',' << repl_policy_name(c.config().repl) << ',' << inclusion_name(c.config().inclusion)
+           << ',' << write_policy_name(c.config().write) << ',' << wbuf_entries(&c)
+           << ',' << victim_entries(&c);
+        for (const auto& f : kStatFields) os << ',' << c.stats().*f.field;
+        os << ',' << level_miss_rate(levels, i) << ',' << level_traffic(c)
+           << ',' << run.records << ',' << run.wall_secs << ',' << accesses_per_sec(run) << "\n";
+    }
+
+    os.flags(flags);
+    os.precision(prec);
 }
@@ -1,14 +1,30 @@
 #ifndef STATS_H
 #define STATS_H
 
-#include "cache.h"
+#include <cstdint>
 #include <ostream>
+#include <vector>
+
+#include "sim.h"
+#include "cache.h"
+
+class TimingModel;
 
 struct AllStats {
     AccessStats l1;
     AccessStats l2; // will remain zeroed if L2_SIZE == 0
 };
 
+// Final path component of 'path' (no directories).
+const char* basename_c(const char* path);
+
+// Print the "Simulator configuration" block ('trace_name' is printed as given;
+// callers pass the basename). Given the built levels, their policies are
+// listed too, but only those that differ from the default (LRU, NINE, WBWA,
+// no write or victim buffers), so default runs keep the reference format.
+void print_sim_config(std::ostream& os, const cache_params_t& params, const char* trace_name,
+                      const Cache* l1 = nullptr, const Cache* l2 = nullptr);
+
 // Print the final report (config block, contents, and measurements).
 // Implement the exact formatting your grader expects here.
 void print_final_report(std::ostream& os,
@@ -16,4 +32,63 @@ void print_final_report(std::ostream& os,
                         const Cache* l2_opt,
                         const AllStats& totals);
 
+// Report line q: every block moved to or from memory (demand fills,
+// writebacks and prefetches of the last level).
+uint64_t memory_traffic(const AllStats& totals);
+
+// ---- Hierarchies of any depth (levels L1 first, see hierarchy.h) ----
+
+// Configuration block listing every level (geometry and replacement policy).
+void print_levels_config(std::ostream& os, const cache_params_t& params,
+                         const std::vector<const Cache*>& levels, const char* trace_name);
+
+// Contents of every level, then per-level measurements: accesses, misses,
+// miss rate (first level: all accesses; lower levels: reads, as on line n),
+// writebacks, prefetches and the traffic each level sends below it. Up to
+// two levels this is exactly the reference report above.
+void print_final_report(std::ostream& os, const std::vector<const Cache*>& levels);
+
+// Blocks 'c' moves to the level below it, or to and from memory for the
+// last level: demand fills (less victim-cache hits), writes (writebacks, or
+// every eviction if the level below is exclusive; write-throughs; less those
+// a write buffer coalesced) and prefetches.
+uint64_t level_traffic(const Cache& c);
+
+// ---- Structured output (--format=json|csv) ----
+// Same run as the text report: configuration, every AccessStats field of
+// each level, derived rates and simulation throughput. Field names follow
+// the AccessStats members; an absent L2 reports zeros.
+
+enum class ReportFormat { Text, Json, Csv };
+
+// "text", "json" or "csv".
+bool parse_report_format(const char* s, ReportFormat& out);
+
+struct RunInfo {
+    const char* trace_name = "";
+    uint64_t    records    = 0;     // trace records simulated
+    double      wall_secs  = 0.0;   // simulation wall time
+    const TimingModel* timing = nullptr;   // --timing: adds a "timing" object to JSON
+};
+
+// One JSON object on a single line, so several runs form JSON Lines.
+void print_json_report(std::ostream& os, const cache_params_t& params,
+                       const Cache& l1, const Cache* l2_opt,
+                       const AllStats& totals, const RunInfo& run);
+
+// CSV: the header once, then one row per run.
+void print_csv_header(std::ostream& os);
+void print_csv_row(std::ostream& os, const cache_params_t& params,
+                   const Cache& l1, const Cache* l2_opt,
+                   const AllStats& totals, const RunInfo& run);
+
+// Any depth: JSON with a "levels" array (name, geometry, policy, every
+// AccessStats field, miss_rate, traffic) in place of "l1"/"l2"; CSV with
+// one row per level.
+void print_json_report(std::ostream& os, const cache_params_t& params,
+                       const std::vector<const Cache*>& levels, const RunInfo& run);
+void print_csv_levels_header(std::ostream& os);
+void print_csv_level_rows(std::ostream& os, const cache_params_t& params,
+                          const std::vector<const Cache*>& levels, const RunInfo& run);
+
 #endif // STATS_H
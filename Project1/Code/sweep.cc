@@ -0,0 +1,205 @@
+/***********************************************************************************
+ * File:        sweep.cc
+ * Author:      Connor Savugot
+ * Created:     2025-09-21
+ * Updated:     2025-09-21
+ * Version:     1.0
+ *
+ * Description: Single-pass multi-configuration simulation. The trace is
+ *              parsed once into batches; each batch is run through every
+ *              configured hierarchy while it is still hot in the CPU caches.
+ *              With several threads, the decoded trace is shared read-only
+ *              and hierarchies are distributed over a work-stealing pool.
+ ***********************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+
+#include "sweep.h"
+#include "hierarchy.h"
+#include "trace_stream.h"
+#include "stats.h"
+#include "thread_pool.h"
+
+bool load_sweep_file(const char* path, std::vector<cache_params_t>& out, std::string& err) {
+    std::ifstream in(path);
+    if (!in) { err = std::string("unable to open ") + path; return false; }
+
+    std::string line;
+    int lineno = 0;
+    while (std::getline(in, line)) {
+        ++lineno;
+        const std::size_t hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+
+        std::istringstream ss(line);
+        uint64_t v[7];
+        int n = 0;
+        while (n < 7 && (ss >> v[n])) ++n;
+        std::string extra;
+        if (n == 0 && ss.eof()) continue;              // blank/comment line
+        if (n != 7 || (ss >> extra)) {
+            err = "line " + std::to_string(lineno) + ": expected 7 numbers "
+                  "(BLOCKSIZE L1_SIZE L1_ASSOC L2_SIZE L2_ASSOC PREF_N PREF_M)";
+            return false;
+        }
+
+        cache_params_t p;
+        p.BLOCKSIZE = (uint32_t)v[0];
+        p.L1_SIZE   = (uint32_t)v[1];
+        p.L1_ASSOC  = (uint32_t)v[2];
+        p.L2_SIZE   = (uint32_t)v[3];
+        p.L2_ASSOC  = (uint32_t)v[4];
+        p.PREF_N    = (uint32_t)v[5];
+        p.PREF_M    = (uint32_t)v[6];
+        std::string why;
+        if (!validate_params(p, why)) {
+            err = "line " + std::to_string(lineno) + ": " + why;
+            return false;
+        }
+        out.push_back(p);
+    }
+    if (out.empty()) { err = "no configurations"; return false; }
+    return true;
+}
+
+// Rough relative cost of simulating one hierarchy, used to hand out the
+// expensive configs first so they do not end up as the stragglers.
+static uint64_t sweep_cost(const cache_params_t& p) {
+    uint64_t cost = 4 + p.L1_ASSOC;
+    if (p.L2_SIZE > 0 && p.L2_ASSOC > 0) cost += 2 + p.L2_ASSOC / 2;
+    return cost;
+}
+
+static int run_sweep_serial(std::vector<std::unique_ptr<Hierarchy>>& hier,
+                            const char* trace_file, std::size_t& records) {
+    std::string err;
+    TraceBatchReader trace;
+    if (!trace.open(trace_file, err)) {
+        printf("Error: Unable to open file %s (%s)\n", trace_file, err.c_str());
+        return EXIT_FAILURE;
+    }
+
+    TraceBatch batch;
+    while (trace.next_batch(batch)) {
+        const std::size_t n = batch.addrs.size();
+        for (auto& h : hier) h->run_batch(batch.addrs.data(), batch.writes.data(), n);
+        records += n;
+        if (batch.status == TraceReader::Status::BadOp) {
+            printf("Error: Unknown request type %c.\n", batch.bad_op);
+            return EXIT_FAILURE;
+        }
+    }
+    if (!trace.error().empty()) {
+        printf("Error: Failed reading %s (%s)\n", trace_file, trace.error().c_str());
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+static int run_sweep_parallel(std::vector<std::unique_ptr<Hierarchy>>& hier,
+                              const char* trace_file, unsigned threads,
+                              std::size_t& records, std::vector<double>& task_secs,
+                              std::size_t& stolen) {
+    std::string err;
+    DecodedTrace trace;
+    if (!load_decoded_trace(trace_file, trace, err)) {
+        printf("Error: Failed reading %s (%s)\n", trace_file, err.c_str());
+        return EXIT_FAILURE;
+    }
+    records = trace.size();
+
+    // Most expensive first, dealt round-robin across the worker deques.
+    std::vector<std::size_t> order(hier.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return sweep_cost(hier[a]->params()) > sweep_cost(hier[b]->params());
+    });
+
+    WorkStealingPool pool(threads);
+    task_secs.assign(hier.size(), 0.0);
+    for (std::size_t k = 0; k < order.size(); ++k) {
+        const std::size_t i = order[k];
+        pool.submit([&, i] {
+            const auto t0 = std::chrono::steady_clock::now();
+            hier[i]->run_batch(trace.addrs.data(), trace.writes.data(), trace.size());
+            task_secs[i] = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - t0).count();
+        }, k);
+    }
+    stolen = pool.run();
+    return EXIT_SUCCESS;
+}
+
+int run_sweep(const char* config_file, const char* trace_file,
+              unsigned threads, bool report_throughput, ReportFormat format) {
+    std::vector<cache_params_t> configs;
+    std::string err;
+    if (!load_sweep_file(config_file, configs, err)) {
+        printf("Error: Invalid sweep file %s (%s)\n", config_file, err.c_str());
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::unique_ptr<Hierarchy>> hier;
+    hier.reserve(configs.size());
+    for (const auto& p : configs) hier.push_back(std::make_unique<Hierarchy>(p));
+
+    const unsigned used = (threads > 1)
+        ? std::min<unsigned>(threads, static_cast<unsigned>(hier.size())) : 1u;
+    std::size_t records = 0;
+    std::size_t stolen  = 0;
+    std::vector<double> task_secs;
+    const auto t_start = std::chrono::steady_clock::now();
+    const int rc = (used > 1)
+        ? run_sweep_parallel(hier, trace_file, used, records, task_secs, stolen)
+        : run_sweep_serial(hier, trace_file, records);
+    if (rc != EXIT_SUCCESS) return rc;
+    const double secs = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - t_start).count();
+
+    const char* name = basename_c(trace_file);
+    if (format == ReportFormat::Csv) print_csv_header(std::cout);
+    for (std::size_t i = 0; i < hier.size(); ++i) {
+        if (format == ReportFormat::Text) {
+            if (i) std::cout << "\n";
+            hier[i]->print_report(std::cout, name);
+            continue;
+        }
+        const Hierarchy& h = *hier[i];
+        AllStats totals;
+        totals.l1 = h.l1().stats();
+        if (h.l2()) totals.l2 = h.l2()->stats();
+        RunInfo run;
+        run.trace_name = name;
+        run.records    = records;
+        run.wall_secs  = task_secs.empty() ? secs : task_secs[i];
+        if (format == ReportFormat::Json) print_json_report(std::cout, h.params(), h.l1(), h.l2(), totals, run);
+        else                              print_csv_row(std::cout, h.params(), h.l1(), h.l2(), totals, run);
+    }
+
+    if (report_throughput) {
+        for (std::size_t i = 0; i < task_secs.size(); ++i) {
+            const cache_params_t& p = hier[i]->params();
+            fprintf(stderr, "config %zu (%u %u %u %u %u %u %u): %.6f s (%.0f accesses/s)\n",
+                    i, p.BLOCKSIZE, p.L1_SIZE, p.L1_ASSOC, p.L2_SIZE, p.L2_ASSOC, p.PREF_N, p.PREF_M,
+                    task_secs[i], task_secs[i] > 0 ? records / task_secs[i] : 0.0);
+        }
+        const double sim = static_cast<double>(records) * hier.size();
+        fprintf(stderr, "sweep: %zu configs x %zu records on %u thread(s) in %.6f s "
+                        "(%.0f simulated accesses/s, %zu stolen)\n",
+                hier.size(), records, used, secs,
+                secs > 0 ? sim / secs : 0.0, stolen);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,36 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "sim.h"
+#include "stats.h"
+
+// Sweep mode: simulate many hierarchies over one pass of the trace.
+//
+// Config file: one hierarchy per line, the same seven numbers as the ./sim
+// command line ("BLOCKSIZE L1_SIZE L1_ASSOC L2_SIZE L2_ASSOC PREF_N PREF_M").
+// Blank lines and '#' comments are ignored.
+
+// Parse 'path' into 'out'. On failure returns false and fills 'err'
+// (with the offending line number).
+bool load_sweep_file(const char* path, std::vector<cache_params_t>& out, std::string& err);
+
+// Print one configuration block + final report per config, in file order,
+// separated by a blank line (--format=text), or one JSON line / CSV row per
+// config. In structured output, wall_seconds is the config's own task time
+// when run in parallel and the whole sweep's time when serial (every batch
+// goes through all configs). Returns a process exit status.
+//
+// threads <= 1: decode the trace once, in batches, and feed every batch to
+//               every hierarchy on the calling thread.
+// threads  > 1: decode the whole trace into memory once, then simulate the
+//               hierarchies in parallel on a work-stealing pool, all reading
+//               the same shared trace.
+int run_sweep(const char* config_file, const char* trace_file,
+              unsigned threads, bool report_throughput,
+              ReportFormat format = ReportFormat::Text);
+
+#endif // SWEEP_H
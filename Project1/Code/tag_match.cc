@@ -0,0 +1,111 @@
+/***********************************************************************************
+ * File:        tag_match.cc
+ * Author:      Connor Savugot
+ * Created:     2025-09-21
+ * Updated:     2025-09-21
+ * Version:     1.0
+ *
+ * Description: Scalar and SIMD (SSE2/AVX2) tag comparison kernels used by
+ *              Cache::find_way, with one-time runtime CPU dispatch.
+ ***********************************************************************************/
+
+#include <cstdint>
+#include <cstddef>
+
+#include "tag_match.h"
+
+#if !defined(CACHE_NO_SIMD) && (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define TAG_MATCH_X86 1
+#include <immintrin.h>
+#endif
+
+// Below this associativity the inline scalar loop in find_way is faster than
+// an indirect call into a vector kernel (see 'make tagbench').
+static const std::size_t kSimdMinAssoc = 12;
+
+int tag_match_scalar(const uint32_t* tags, const uint8_t* state, int n,
+                     uint32_t tag, uint8_t valid_bit) {
+    for (int w = 0; w < n; ++w) {
+        if (tags[w] == tag && (state[w] & valid_bit)) return w;
+    }
+    return -1;
+}
+
+#ifdef TAG_MATCH_X86
+
+// Walk the set bits of a compare mask; stale tags in invalid ways can match,
+// so each hit is confirmed against the state byte.
+static inline int first_valid(unsigned mask, int base, const uint8_t* state, uint8_t valid_bit) {
+    while (mask) {
+        const int w = base + __builtin_ctz(mask);
+        if (state[w] & valid_bit) return w;
+        mask &= mask - 1;
+    }
+    return -1;
+}
+
+static int tag_match_sse2(const uint32_t* tags, const uint8_t* state, int n,
+                          uint32_t tag, uint8_t valid_bit) {
+    const __m128i key = _mm_set1_epi32(static_cast<int>(tag));
+    int w = 0;
+    for (; w + 4 <= n; w += 4) {
+        const __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tags + w));
+        const unsigned m = static_cast<unsigned>(
+            _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(t, key))));
+        if (m) {
+            const int hit = first_valid(m, w, state, valid_bit);
+            if (hit >= 0) return hit;
+        }
+    }
+    for (; w < n; ++w) {
+        if (tags[w] == tag && (state[w] & valid_bit)) return w;
+    }
+    return -1;
+}
+
+__attribute__((target("avx2")))
+static int tag_match_avx2(const uint32_t* tags, const uint8_t* state, int n,
+                          uint32_t tag, uint8_t valid_bit) {
+    const __m256i key = _mm256_set1_epi32(static_cast<int>(tag));
+    int w = 0;
+    for (; w + 8 <= n; w += 8) {
+        const __m256i t = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tags + w));
+        const unsigned m = static_cast<unsigned>(
+            _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(t, key))));
+        if (m) {
+            const int hit = first_valid(m, w, state, valid_bit);
+            if (hit >= 0) return hit;
+        }
+    }
+    for (; w < n; ++w) {
+        if (tags[w] == tag && (state[w] & valid_bit)) return w;
+    }
+    return -1;
+}
+
+#endif // TAG_MATCH_X86
+
+TagMatchFn tag_match_best() {
+#ifdef TAG_MATCH_X86
+    static const TagMatchFn fn =
+        __builtin_cpu_supports("avx2") ? tag_match_avx2 : tag_match_sse2;
+    return fn;
+#else
+    return tag_match_scalar;
+#endif
+}
+
+const char* tag_match_best_name() {
+#ifdef TAG_MATCH_X86
+    return __builtin_cpu_supports("avx2") ? "avx2" : "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+TagMatchFn tag_match_for_assoc(std::size_t assoc) {
+    if (assoc < kSimdMinAssoc) return nullptr;
+    const TagMatchFn fn = tag_match_best();
+    return (fn == tag_match_scalar) ? nullptr : fn;
+}
@@ -0,0 +1,27 @@
+#ifndef TAG_MATCH_H
+#define TAG_MATCH_H
+
+#include <cstdint>
+#include <cstddef>
+
+// Tag-match kernels for Cache::find_way. Each returns the first way w in
+// [0, n) with tags[w] == tag and (state[w] & valid_bit), or -1 on a miss.
+// SIMD variants compare a whole run of tags per instruction and only look at
+// the state byte of ways whose tag matched.
+
+typedef int (*TagMatchFn)(const uint32_t* tags, const uint8_t* state, int n,
+                          uint32_t tag, uint8_t valid_bit);
+
+int tag_match_scalar(const uint32_t* tags, const uint8_t* state, int n,
+                     uint32_t tag, uint8_t valid_bit);
+
+// Best kernel for this CPU (AVX2, then SSE2 on x86; scalar elsewhere or when
+// built with -DCACHE_NO_SIMD), chosen once at runtime.
+TagMatchFn tag_match_best();
+const char* tag_match_best_name();
+
+// Kernel Cache uses for a set of 'assoc' ways: nullptr means "use the inline
+// scalar loop", which wins for low associativity.
+TagMatchFn tag_match_for_assoc(std::size_t assoc);
+
+#endif // TAG_MATCH_H
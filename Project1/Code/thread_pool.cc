@@ -0,0 +1,80 @@
+/***********************************************************************************
+ * File:        thread_pool.cc
+ * Author:      Connor Savugot
+ * Created:     2025-09-21
+ * Updated:     2025-09-21
+ * Version:     1.0
+ *
+ * Description: Work-stealing thread pool used by the parallel sweep runner.
+ ***********************************************************************************/
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "thread_pool.h"
+
+WorkStealingPool::WorkStealingPool(unsigned threads) : queues_(threads ? threads : 1) {}
+
+unsigned WorkStealingPool::default_threads() {
+    const unsigned n = std::thread::hardware_concurrency();
+    return n ? n : 1;
+}
+
+void WorkStealingPool::submit(Task task, std::size_t hint) {
+    Queue& q = queues_[hint % queues_.size()];
+    std::lock_guard<std::mutex> lk(q.mu);
+    q.tasks.push_back(std::move(task));
+}
+
+bool WorkStealingPool::pop_own_(std::size_t self, Task& out) {
+    Queue& q = queues_[self];
+    std::lock_guard<std::mutex> lk(q.mu);
+    if (q.tasks.empty()) return false;
+    out = std::move(q.tasks.front());
+    q.tasks.pop_front();
+    return true;
+}
+
+bool WorkStealingPool::steal_(std::size_t self, Task& out) {
+    const std::size_t n = queues_.size();
+    for (std::size_t k = 1; k < n; ++k) {
+        Queue& q = queues_[(self + k) % n];
+        std::lock_guard<std::mutex> lk(q.mu);
+        if (q.tasks.empty()) continue;
+        out = std::move(q.tasks.back());
+        q.tasks.pop_back();
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::worker_(std::size_t self, std::size_t& stolen) {
+    // No task ever enqueues more work, so once every deque is empty we are done.
+    Task task;
+    while (true) {
+        if (pop_own_(self, task)) {
+            task();
+        } else if (steal_(self, task)) {
+            ++stolen;
+            task();
+        } else {
+            return;
+        }
+    }
+}
+
+std::size_t WorkStealingPool::run() {
+    std::vector<std::size_t> stolen(queues_.size(), 0);
+    std::vector<std::thread> workers;
+    workers.reserve(queues_.size() - 1);
+    for (std::size_t t = 1; t < queues_.size(); ++t) {
+        workers.emplace_back([this, t, &stolen]{ worker_(t, stolen[t]); });
+    }
+    worker_(0, stolen[0]);
+    for (auto& w : workers) w.join();
+
+    std::size_t total = 0;
+    for (std::size_t s : stolen) total += s;
+    return total;
+}
@@ -0,0 +1,47 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+// Work-stealing pool for coarse, independent tasks (e.g. one cache
+// hierarchy each). Every worker owns a deque: it takes work from the front
+// of its own deque and, when that runs dry, steals from the back of the
+// others', so a few long-running tasks never leave the remaining cores idle.
+// Tasks are coarse, so a mutex per deque costs nothing measurable.
+
+class WorkStealingPool {
+public:
+    typedef std::function<void()> Task;
+
+    explicit WorkStealingPool(unsigned threads);
+
+    // Queue a task on worker 'hint % threads' (before run()).
+    void submit(Task task, std::size_t hint);
+
+    // Run every queued task to completion on 'threads' threads (the calling
+    // thread is worker 0). Returns the number of tasks executed by stealing.
+    std::size_t run();
+
+    unsigned threads() const { return static_cast<unsigned>(queues_.size()); }
+
+    // Hardware thread count, at least 1.
+    static unsigned default_threads();
+
+private:
+    struct Queue {
+        std::mutex       mu;
+        std::deque<Task> tasks;
+    };
+
+    bool pop_own_(std::size_t self, Task& out);
+    bool steal_(std::size_t self, Task& out);
+    void worker_(std::size_t self, std::size_t& stolen);
+
+    std::vector<Queue> queues_;
+};
+
+#endif // THREAD_POOL_H
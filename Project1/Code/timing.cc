@@ -0,0 +1,167 @@
+/***********************************************************************************
+ * File:        timing.cc
+ * Author:      Connor Savugot
+ * Created:     2025-09-21
+ * Updated:     2025-09-21
+ * Version:     1.0
+ *
+ * Description: Non-blocking cache timing model: per-level hit latencies, MSHRs
+ *              with miss merging, memory latency, driven by a binary-heap
+ *              event queue of MSHR releases. Reports cycles and AMAT.
+ ***********************************************************************************/
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "timing.h"
+
+TimingModel::TimingModel(Hierarchy& hier) : hier_(hier) {
+    const HierarchySpec& spec = hier.spec();
+    uint64_t path = 0;
+    for (std::size_t i = 0; i < hier.depth(); ++i) {
+        const LevelSpec& lv = spec.levels[i];
+        levels_.push_back(Level{ &hier.level(i), lv.hit_latency, lv.mshrs, {}, {} });
+        levels_.back().active.reserve(lv.mshrs);
+        path += lv.hit_latency;
+        path_latency_.push_back(path);
+    }
+    path_latency_.push_back(path + spec.mem_latency);
+    off_bits_ = hier.l1().address_map().off_bits;
+}
+
+double TimingModel::amat() const {
+    return accesses_ ? static_cast<double>(total_latency_) / static_cast<double>(accesses_) : 0.0;
+}
+
+int TimingModel::find_(const Level& lv, uint32_t block) const {
+    for (std::size_t i = 0; i < lv.active.size(); ++i) {
+        if (lv.active[i].block == block) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+void TimingModel::release_(const Event& e) {
+    Level& lv = levels_[e.level];
+    const int i = find_(lv, e.block);
+    if (i < 0) return;
+    lv.active[i] = lv.active.back();
+    lv.active.pop_back();
+}
+
+void TimingModel::release_until_(uint64_t t) {
+    while (!events_.empty() && events_.top().time <= t) {
+        const Event e = events_.top();
+        events_.pop();
+        release_(e);
+    }
+}
+
+void TimingModel::wait_for_mshr_(std::size_t level) {
+    Level& lv = levels_[level];
+    // Every active MSHR has its release queued, so the heap is not empty.
+    while (lv.active.size() >= lv.capacity) {
+        const Event e = events_.top();
+        events_.pop();
+        if (e.time > now_) {
+            lv.stats.mshr_stall_cycles += e.time - now_;
+            now_ = e.time;
+        }
+        release_(e);
+    }
+}
+
+void TimingModel::allocate_(std::size_t level, uint32_t block, uint64_t ready) {
+    Level& lv = levels_[level];
+    lv.active.push_back(Mshr{ block, ready });
+    lv.stats.mshr_peak = std::max(lv.stats.mshr_peak, static_cast<uint32_t>(lv.active.size()));
+    events_.push(Event{ ready, static_cast<uint32_t>(level), block });
+}
+
+void TimingModel::access(Cache::Op op, uint32_t addr) {
+    const uint64_t due = next_issue_;
+    now_ = due;
+    if (blocked_until_ > now_) {
+        // Blocking L1: the previous miss still holds the core.
+        levels_[0].stats.mshr_stall_cycles += blocked_until_ - now_;
+        now_ = blocked_until_;
+    }
+    release_until_(now_);
+
+    Cache& l1 = hier_.l1();
+    const bool hit = l1.access(op, addr, l1.next_level());
+    const uint32_t block = addr >> off_bits_;
+    const bool blocking = levels_[0].capacity == 0;
+
+    uint64_t done;
+    const int merge_l1 = find_(levels_[0], block);
+    const uint32_t depth = hit ? 0 : std::min<uint32_t>(l1.last_service_depth(),
+                                                        static_cast<uint32_t>(levels_.size()));
+    if (merge_l1 >= 0) {
+        // Secondary miss: the block is still on its way to L1.
+        levels_[0].stats.mshr_merges += 1;
+        done = std::max(now_ + path_latency_[0], levels_[0].active[merge_l1].ready);
+    } else if (depth == 0) {
+        done = now_ + path_latency_[0];
+    } else {
+        // Primary miss in levels [0, depth): one MSHR per level, unless the
+        // block is already in flight at one of them.
+        if (!blocking) wait_for_mshr_(0);
+        std::size_t k = 1;
+        int merge = -1;
+        for (; k < depth; ++k) {
+            merge = find_(levels_[k], block);
+            if (merge >= 0) break;
+            wait_for_mshr_(k);
+        }
+        if (merge >= 0) {
+            levels_[k].stats.mshr_merges += 1;
+            done = std::max(now_ + path_latency_[k], levels_[k].active[merge].ready);
+        } else {
+            done = now_ + path_latency_[depth];
+        }
+        for (std::size_t j = blocking ? 1 : 0; j < k; ++j) allocate_(j, block, done);
+        if (blocking) blocked_until_ = done;
+    }
+
+    accesses_      += 1;
+    total_latency_ += done - due;
+    cycles_         = std::max(cycles_, done);
+    next_issue_     = now_ + 1;
+}
+
+void TimingModel::print(std::ostream& os) const {
+    const int label_w = 32;
+    auto print_wide = [&](const std::string& label, uint64_t v) {
+        os << label << ' ' << std::setw(std::max(0, label_w - (int)label.size())) << v << "\n";
+    };
+    os << "===== Timing =====\n";
+    for (const Level& lv : levels_) {
+        print_wide(lv.cache->config().name + " hit latency:", lv.hit_latency);
+    }
+    print_wide("memory latency:", mem_latency());
+    for (const Level& lv : levels_) {
+        const std::string label = lv.cache->config().name + " MSHRs:";
+        if (lv.capacity == 0) {
+            os << label << ' ' << std::setw(std::max(0, label_w - (int)label.size())) << "blocking" << "\n";
+        } else {
+            print_wide(label, lv.capacity);
+        }
+    }
+    print_wide("cycles:", cycles_);
+    const std::ios::fmtflags flags = os.flags();
+    os << "AMAT (cycles):" << ' ' << std::setw(label_w - 14)
+       << std::fixed << std::setprecision(4) << amat() << "\n";
+    os.flags(flags);
+    os << std::setprecision(6);
+    for (const Level& lv : levels_) {
+        const std::string& name = lv.cache->config().name;
+        print_wide(name + " MSHR merges:",       lv.stats.mshr_merges);
+        print_wide(name + " MSHR stall cycles:", lv.stats.mshr_stall_cycles);
+        print_wide(name + " MSHR peak:",         lv.stats.mshr_peak);
+    }
+}
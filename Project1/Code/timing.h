@@ -0,0 +1,115 @@
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <queue>
+#include <vector>
+
+#include "cache.h"
+#include "hierarchy.h"
+
+// Optional timing layer over the functional hierarchy (./sim --timing).
+//
+// The core issues one trace record per cycle. Each record is first simulated
+// functionally (state stays in trace order), then timed from where its block
+// came from (Cache::last_service_depth): a hit costs the level's hit latency;
+// a miss served by level d costs every lookup latency down to d, plus the
+// memory latency when d is memory. Writebacks, write-throughs and victim
+// fills are off the critical path.
+//
+// Misses are non-blocking. A primary miss holds an MSHR (miss-status holding
+// register) at every level it missed in until its block arrives. A later
+// access to a block that is still in flight at some level - even one the
+// functional model already counts as a hit - merges into that MSHR and
+// completes when the block arrives. When a level runs out of MSHRs the core
+// stalls until one frees. With 0 MSHRs at the first level it is a blocking
+// cache: every miss stalls the core until it completes, and that stall counts
+// as L1 MSHR stall cycles against the next record.
+//
+// MSHR releases are events in a binary heap (earliest first), popped as
+// simulated time passes them; hits touch the heap not at all, and a miss
+// costs O(log outstanding misses).
+//
+// Reported: total cycles (the last completion), AMAT and, per level, MSHR
+// merges, stall cycles and peak occupancy. A record is due to issue the
+// cycle after its predecessor issued; its latency runs from that cycle to
+// its completion, so it includes any stall it issued behind (waiting for an
+// MSHR, or for the previous miss of a blocking L1) but not the stalls of
+// earlier records. AMAT is the mean of these latencies, defined the same way
+// for blocking and non-blocking caches. Latencies of overlapping accesses
+// overlap (every access merged into a miss waits for it), so compare cycles,
+// not AMAT, for throughput.
+
+struct TimingLevelStats {
+    uint64_t mshr_merges       = 0;   // accesses merged into an in-flight miss
+    uint64_t mshr_stall_cycles = 0;   // issue delayed waiting for a free MSHR
+    uint32_t mshr_peak         = 0;   // most MSHRs in use at once
+};
+
+class TimingModel {
+public:
+    // Latencies and MSHR counts come from hier.spec() (see hierarchy.h).
+    explicit TimingModel(Hierarchy& hier);
+
+    // Simulate one record functionally and time it.
+    void access(Cache::Op op, uint32_t addr);
+
+    uint64_t accesses() const { return accesses_; }
+    uint64_t cycles()   const { return cycles_; }
+    double   amat()     const;
+
+    // Parameters and counters per level (L1 first).
+    std::size_t depth() const { return levels_.size(); }
+    uint32_t hit_latency(std::size_t i) const { return levels_[i].hit_latency; }
+    uint32_t mshrs(std::size_t i)       const { return levels_[i].capacity; }
+    uint32_t mem_latency() const {
+        return static_cast<uint32_t>(path_latency_.back() - path_latency_[levels_.size() - 1]);
+    }
+    const TimingLevelStats& level_stats(std::size_t i) const { return levels_[i].stats; }
+
+    // "===== Timing =====" block: parameters, cycles, AMAT and MSHR counters.
+    void print(std::ostream& os) const;
+
+private:
+    struct Mshr {
+        uint32_t block;
+        uint64_t ready;      // cycle the block arrives at this level
+    };
+    struct Level {
+        const Cache*      cache;
+        uint32_t          hit_latency;
+        uint32_t          capacity;   // MSHRs
+        std::vector<Mshr> active;     // in flight, unordered
+        TimingLevelStats  stats;
+    };
+    struct Event {
+        uint64_t time;
+        uint32_t level;
+        uint32_t block;
+        bool operator>(const Event& o) const { return time > o.time; }
+    };
+
+    Hierarchy&               hier_;
+    std::vector<Level>       levels_;
+    std::vector<uint64_t>    path_latency_;   // [d]: lookups down to level d (+ memory at depth())
+    uint32_t                 off_bits_ = 0;
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events_;
+
+    uint64_t now_        = 0;   // issue cycle of the current record
+    uint64_t next_issue_ = 0;   // cycle the next record is due to issue
+    uint64_t blocked_until_ = 0;   // blocking L1: core held until this cycle
+    uint64_t cycles_     = 0;
+    uint64_t accesses_   = 0;
+    uint64_t total_latency_ = 0;
+
+    int  find_(const Level& lv, uint32_t block) const;
+    void release_(const Event& e);
+    void release_until_(uint64_t t);
+    void wait_for_mshr_(std::size_t level);
+    void allocate_(std::size_t level, uint32_t block, uint64_t ready);
+};
+
+#endif // TIMING_H
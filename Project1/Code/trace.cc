@@ -0,0 +1,150 @@
+/***********************************************************************************
+ * File:        trace.cc
+ * Author:      Connor Savugot
+ * Created:     2025-09-21
+ * Updated:     2025-09-21
+ * Version:     1.0
+ *
+ * Description: Memory-mapped trace reader. Maps the trace file read-only and
+ *              hands the raw bytes to the inline decoders in trace.h.
+ *              Falls back to a single buffered read when mmap is unavailable
+ *              (e.g. pipes or empty files). Also detects/validates and
+ *              writes the packed binary trace format.
+ ***********************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "trace.h"
+
+TraceReader::TraceReader(const char* path) {
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) return;
+
+    struct stat st;
+    if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        void* m = ::mmap(nullptr, static_cast<std::size_t>(st.st_size),
+                         PROT_READ, MAP_PRIVATE, fd, 0);
+        if (m != MAP_FAILED) {
+#ifdef MADV_SEQUENTIAL
+            ::madvise(m, static_cast<std::size_t>(st.st_size), MADV_SEQUENTIAL);
+#endif
+            base_   = static_cast<const char*>(m);
+            len_    = static_cast<std::size_t>(st.st_size);
+            mapped_ = true;
+        }
+    }
+
+    if (!mapped_) {
+        // Fallback: slurp the stream into one heap buffer.
+        std::vector<char> buf;
+        char chunk[1 << 16];
+        ssize_t n;
+        while ((n = ::read(fd, chunk, sizeof(chunk))) > 0) {
+            buf.insert(buf.end(), chunk, chunk + n);
+        }
+        if (n < 0) { ::close(fd); return; }
+        char* owned = new char[buf.size() ? buf.size() : 1];
+        std::copy(buf.begin(), buf.end(), owned);
+        base_ = owned;
+        len_  = buf.size();
+    }
+
+    ::close(fd);
+    cur_  = base_;
+    end_  = base_ + len_;
+    open_ = true;
+
+    if (len_ >= sizeof(TRACE_BIN_MAGIC) &&
+        memcmp(base_, TRACE_BIN_MAGIC, sizeof(TRACE_BIN_MAGIC)) == 0) {
+        open_ = open_binary_();
+    }
+}
+
+static inline uint32_t load_le32(const unsigned char* p) {
+    return static_cast<uint32_t>(p[0])        | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static inline uint64_t load_le64(const unsigned char* p) {
+    return static_cast<uint64_t>(load_le32(p)) | (static_cast<uint64_t>(load_le32(p + 4)) << 32);
+}
+
+static inline void store_le32(unsigned char* p, uint32_t v) {
+    p[0] = static_cast<unsigned char>(v);
+    p[1] = static_cast<unsigned char>(v >> 8);
+    p[2] = static_cast<unsigned char>(v >> 16);
+    p[3] = static_cast<unsigned char>(v >> 24);
+}
+
+static inline void store_le64(unsigned char* p, uint64_t v) {
+    store_le32(p, static_cast<uint32_t>(v));
+    store_le32(p + 4, static_cast<uint32_t>(v >> 32));
+}
+
+bool TraceReader::open_binary_() {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(base_);
+    if (len_ < sizeof(TraceBinHeader)) { error_ = "truncated binary trace header"; return false; }
+
+    const uint32_t version  = load_le32(p + 8);
+    const uint64_t count    = load_le64(p + 16);
+    const uint64_t checksum = load_le64(p + 24);
+    if (version != TRACE_BIN_VERSION) { error_ = "unsupported binary trace version"; return false; }
+
+    const std::size_t addr_bytes = static_cast<std::size_t>(count) * 4;
+    const std::size_t op_bytes   = static_cast<std::size_t>((count + 7) / 8);
+    if (count > (len_ / 4) || len_ - sizeof(TraceBinHeader) != addr_bytes + op_bytes) {
+        error_ = "binary trace size does not match header";
+        return false;
+    }
+
+    const unsigned char* payload = p + sizeof(TraceBinHeader);
+    if (trace_bin_checksum(payload, addr_bytes + op_bytes) != checksum) {
+        error_ = "binary trace checksum mismatch";
+        return false;
+    }
+
+    binary_    = true;
+    bin_addrs_ = payload;
+    bin_ops_   = payload + addr_bytes;
+    bin_count_ = static_cast<std::size_t>(count);
+    return true;
+}
+
+bool write_binary_trace(const char* path, const uint32_t* addrs,
+                        const unsigned char* write_bits, std::size_t count) {
+    const std::size_t addr_bytes = count * 4;
+    const std::size_t op_bytes   = (count + 7) / 8;
+    std::vector<unsigned char> out(sizeof(TraceBinHeader) + addr_bytes + op_bytes);
+
+    unsigned char* payload = out.data() + sizeof(TraceBinHeader);
+    for (std::size_t i = 0; i < count; ++i) store_le32(payload + 4 * i, addrs[i]);
+    if (op_bytes) memcpy(payload + addr_bytes, write_bits, op_bytes);
+
+    memcpy(out.data(), TRACE_BIN_MAGIC, sizeof(TRACE_BIN_MAGIC));
+    store_le32(out.data() + 8, TRACE_BIN_VERSION);
+    store_le32(out.data() + 12, 0);
+    store_le64(out.data() + 16, count);
+    store_le64(out.data() + 24, trace_bin_checksum(payload, addr_bytes + op_bytes));
+
+    FILE* fp = fopen(path, "wb");
+    if (!fp) return false;
+    const bool ok = fwrite(out.data(), 1, out.size(), fp) == out.size();
+    return (fclose(fp) == 0) && ok;
+}
+
+TraceReader::~TraceReader() {
+    if (!base_) return;
+    if (mapped_) ::munmap(const_cast<char*>(base_), len_);
+    else         delete[] base_;
+}
@@ -0,0 +1,156 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <cstdint>
+#include <cstddef>
+
+#include "cache.h"
+
+// Zero-copy reader for text traces ("r|w <hex>" per line) and for the packed
+// binary format written by trace2bin. The whole file is mapped read-only and
+// records are decoded straight from the mapped bytes, so the hot loop makes no
+// per-record libc calls. The format is detected from the file header.
+
+// ---- Binary trace format (all integers little-endian) ----
+//   header   : TraceBinHeader (32 bytes)
+//   addresses: uint32_t[count]
+//   ops      : ceil(count / 8) bytes, bit i set -> record i is a write
+// The checksum is an FNV-1a style hash over the payload (address words then
+// op bitmap), folded 8 bytes at a time so validation runs near memory speed.
+struct TraceBinHeader {
+    char     magic[8];     // TRACE_BIN_MAGIC
+    uint32_t version;      // TRACE_BIN_VERSION
+    uint32_t reserved;     // 0
+    uint64_t count;        // number of records
+    uint64_t checksum;     // trace_bin_checksum() of the payload
+};
+
+static const char     TRACE_BIN_MAGIC[8]  = { 'T','R','C','4','6','3','B','\0' };
+static const uint32_t TRACE_BIN_VERSION   = 1;
+
+// Payload checksum: FNV-1a over little-endian 64-bit words, then tail bytes.
+static inline uint64_t trace_bin_checksum(const unsigned char* p, std::size_t len) {
+    uint64_t h = 1469598103934665603ULL;
+    std::size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t w = 0;
+        for (int b = 7; b >= 0; --b) w = (w << 8) | p[i + b];
+        h = (h ^ w) * 1099511628211ULL;
+    }
+    for (; i < len; ++i) h = (h ^ p[i]) * 1099511628211ULL;
+    return h;
+}
+
+// Write 'count' records to 'path' in the binary format. Returns false on I/O error.
+bool write_binary_trace(const char* path, const uint32_t* addrs,
+                        const unsigned char* write_bits, std::size_t count);
+
+class TraceReader {
+public:
+    enum class Status { Ok, End, BadOp };
+
+    explicit TraceReader(const char* path);
+    ~TraceReader();
+
+    TraceReader(const TraceReader&) = delete;
+    TraceReader& operator=(const TraceReader&) = delete;
+
+    // False if the file could not be opened/mapped, or a binary trace failed
+    // its header/checksum validation (see error()).
+    bool is_open() const { return open_; }
+    const char* error() const { return error_; }
+
+    // True if the file was recognised as a trace2bin binary trace.
+    bool is_binary() const { return binary_; }
+
+    // Decode the next record. On BadOp, 'bad_op' holds the offending character.
+    inline Status next(Cache::Op& op, uint32_t& addr, char& bad_op);
+
+    // Number of records successfully decoded so far.
+    std::size_t records() const { return records_; }
+
+private:
+    const char* base_   = nullptr; // start of mapped (or buffered) bytes
+    const char* cur_    = nullptr;
+    const char* end_    = nullptr;
+    std::size_t len_    = 0;
+    bool        mapped_ = false;   // true -> munmap, false -> delete[]
+    bool        open_   = false;
+    const char* error_  = nullptr;
+    std::size_t records_ = 0;
+
+    // Binary format cursor
+    bool                 binary_    = false;
+    const unsigned char* bin_addrs_ = nullptr;
+    const unsigned char* bin_ops_   = nullptr;
+    std::size_t          bin_count_ = 0;
+
+    bool open_binary_();
+};
+
+// Hex digit value, or -1 if 'c' is not a hex digit.
+static inline int trace_hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    c = static_cast<char>(c | 0x20); // fold to lower case
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+static inline bool trace_is_space(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f';
+}
+
+// Decode one text record from [cur, end) and advance 'cur' past it.
+// Mirrors fscanf(" %c %x"): skip whitespace, take one op character, skip
+// whitespace, then parse hex digits (optional 0x prefix). A missing address
+// ends the trace, as the fscanf loop did.
+static inline TraceReader::Status trace_decode_text(const char*& cur, const char* end,
+                                                    Cache::Op& op, uint32_t& addr, char& bad_op) {
+    const char* p = cur;
+    while (p < end && trace_is_space(*p)) ++p;
+    if (p >= end) { cur = p; return TraceReader::Status::End; }
+
+    const char rw = *p++;
+    while (p < end && trace_is_space(*p)) ++p;
+
+    if (p + 1 < end && p[0] == '0' && (p[1] | 0x20) == 'x' &&
+        p + 2 < end && trace_hex_value(p[2]) >= 0) {
+        p += 2;
+    }
+
+    uint32_t value = 0;
+    const char* digits = p;
+    int d;
+    while (p < end && (d = trace_hex_value(*p)) >= 0) {
+        value = (value << 4) | static_cast<uint32_t>(d);
+        ++p;
+    }
+    cur = p;
+    if (p == digits) return TraceReader::Status::End;
+
+    if (rw == 'r' || rw == 'R')      op = Cache::Op::Read;
+    else if (rw == 'w' || rw == 'W') op = Cache::Op::Write;
+    else { bad_op = rw; return TraceReader::Status::BadOp; }
+
+    addr = value;
+    return TraceReader::Status::Ok;
+}
+
+inline TraceReader::Status TraceReader::next(Cache::Op& op, uint32_t& addr, char& bad_op) {
+    if (binary_) {
+        const std::size_t i = records_;
+        if (i >= bin_count_) return Status::End;
+        const unsigned char* a = bin_addrs_ + 4 * i;
+        addr = static_cast<uint32_t>(a[0])        | (static_cast<uint32_t>(a[1]) << 8) |
+               (static_cast<uint32_t>(a[2]) << 16) | (static_cast<uint32_t>(a[3]) << 24);
+        op = ((bin_ops_[i >> 3] >> (i & 7)) & 1) ? Cache::Op::Write : Cache::Op::Read;
+        records_ = i + 1;
+        return Status::Ok;
+    }
+
+    const Status st = trace_decode_text(cur_, end_, op, addr, bad_op);
+    if (st == Status::Ok) ++records_;
+    return st;
+}
+
+#endif // TRACE_H
@@ -0,0 +1,63 @@
+/***********************************************************************************
+ * File:        trace2bin.cc
+ * Author:      Connor Savugot
+ * Created:     2025-09-21
+ * Updated:     2025-09-21
+ * Version:     1.0
+ *
+ * Description: Converts a text trace ("r|w <hex>" per line) into the packed
+ *              binary trace format understood by ./sim (see trace.h).
+ ***********************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "trace.h"
+
+/*  Example:
+    ./trace2bin traces/gcc_trace.txt gcc_trace.bin
+    ./sim 32 8192 4 262144 8 0 0 gcc_trace.bin
+*/
+int main (int argc, char *argv[]) {
+   if (argc != 3) {
+      printf("Usage: %s TEXT_TRACE BINARY_TRACE\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   TraceReader trace(argv[1]);
+   if (!trace.is_open()) {
+      printf("Error: Unable to open file %s\n", argv[1]);
+      exit(EXIT_FAILURE);
+   }
+   if (trace.is_binary()) {
+      printf("Error: %s is already a binary trace\n", argv[1]);
+      exit(EXIT_FAILURE);
+   }
+
+   std::vector<uint32_t>      addrs;
+   std::vector<unsigned char> write_bits;
+   Cache::Op op;
+   uint32_t addr;
+   char bad_op = 0;
+   TraceReader::Status st;
+   while ((st = trace.next(op, addr, bad_op)) == TraceReader::Status::Ok) {
+      const std::size_t i = addrs.size();
+      if ((i & 7) == 0) write_bits.push_back(0);
+      if (op == Cache::Op::Write) write_bits[i >> 3] |= static_cast<unsigned char>(1u << (i & 7));
+      addrs.push_back(addr);
+   }
+   if (st == TraceReader::Status::BadOp) {
+      printf("Error: Unknown request type %c.\n", bad_op);
+      exit(EXIT_FAILURE);
+   }
+
+   if (!write_binary_trace(argv[2], addrs.data(), write_bits.data(), addrs.size())) {
+      printf("Error: Unable to write file %s\n", argv[2]);
+      exit(EXIT_FAILURE);
+   }
+   printf("%zu records written to %s\n", addrs.size(), argv[2]);
+   return 0;
+}
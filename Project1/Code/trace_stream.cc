@@ -0,0 +1,220 @@
+/***********************************************************************************
+ * File:        trace_stream.cc
+ * Author:      Connor Savugot
+ * Created:     2025-09-21
+ * Updated:     2025-09-21
+ * Version:     1.0
+ *
+ * Description: Streaming gzip trace input. A producer thread inflates the
+ *              trace in fixed-size chunks, decodes complete lines into
+ *              record batches, and queues them for the simulation thread.
+ *              TraceBatchReader offers the same batches for any trace file.
+ ***********************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <thread>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#include "trace_stream.h"
+
+bool CompressedTraceReader::is_compressed(const char* path) {
+    FILE* fp = fopen(path, "rb");
+    if (!fp) return false;
+    unsigned char magic[2] = { 0, 0 };
+    const bool ok = fread(magic, 1, 2, fp) == 2;
+    fclose(fp);
+    return ok && magic[0] == 0x1f && magic[1] == 0x8b;
+}
+
+CompressedTraceReader::CompressedTraceReader(const char* path,
+                                             std::size_t batch_records,
+                                             std::size_t queue_depth)
+: queue_(queue_depth), batch_records_(batch_records ? batch_records : 1) {
+#ifdef HAVE_ZLIB
+    gzFile gz = gzopen(path, "rb");
+    if (!gz) {
+        error_ = "unable to open compressed trace";
+        queue_.close();
+        return;
+    }
+    gzbuffer(gz, 1u << 17);
+    open_   = true;
+    worker_ = std::thread([this, gz]{ produce_(gz); });
+#else
+    (void)path;
+    error_ = "compressed traces require a build with zlib (HAVE_ZLIB)";
+    queue_.close();
+#endif
+}
+
+CompressedTraceReader::~CompressedTraceReader() {
+    queue_.close();             // unblock the producer if we stopped early
+    if (worker_.joinable()) worker_.join();
+}
+
+void CompressedTraceReader::produce_(void* handle) {
+#ifdef HAVE_ZLIB
+    gzFile gz = static_cast<gzFile>(handle);
+    const std::size_t chunk = 1u << 18;
+    std::vector<char> buf;       // carried-over partial line + fresh chunk
+    std::size_t       carry = 0;
+    bool              eof   = false;
+    bool              first = true;
+
+    TraceBatch batch;
+    batch.addrs.reserve(batch_records_);
+    batch.writes.reserve(batch_records_);
+
+    auto flush = [&](TraceReader::Status st, char bad) -> bool {
+        batch.status = st;
+        batch.bad_op = bad;
+        const bool more = queue_.push(std::move(batch));
+        batch = TraceBatch();
+        batch.addrs.reserve(batch_records_);
+        batch.writes.reserve(batch_records_);
+        return more;
+    };
+
+    while (!eof) {
+        buf.resize(carry + chunk);
+        const int n = gzread(gz, buf.data() + carry, static_cast<unsigned>(chunk));
+        if (n < 0) {
+            int errnum = 0;
+            error_ = gzerror(gz, &errnum);
+            break;
+        }
+        eof = (n == 0);
+        const std::size_t avail = carry + static_cast<std::size_t>(n);
+
+        if (first && avail >= sizeof(TRACE_BIN_MAGIC)) {
+            first = false;
+            if (memcmp(buf.data(), TRACE_BIN_MAGIC, sizeof(TRACE_BIN_MAGIC)) == 0) {
+                error_ = "compressed binary traces are not supported; compress the text trace";
+                break;
+            }
+        }
+
+        // Decode only up to the last newline unless this is the final chunk,
+        // so no record is split across chunks.
+        const char* p   = buf.data();
+        const char* end = p + avail;
+        if (!eof) {
+            const char* nl = end;
+            while (nl > p && nl[-1] != '\n') --nl;
+            end = nl;
+        }
+
+        Cache::Op op;
+        uint32_t addr;
+        char bad = 0;
+        TraceReader::Status st;
+        const char* rec = p;     // start of the record being decoded
+        while ((st = trace_decode_text(p, end, op, addr, bad)) == TraceReader::Status::Ok) {
+            rec = p;
+            batch.addrs.push_back(addr);
+            batch.writes.push_back(op == Cache::Op::Write ? 1 : 0);
+            if (batch.addrs.size() == batch_records_ &&
+                !flush(TraceReader::Status::Ok, 0)) {
+                gzclose(gz);
+                return;          // consumer went away
+            }
+        }
+        if (st == TraceReader::Status::BadOp) {
+            flush(st, bad);
+            gzclose(gz);
+            queue_.close();
+            return;
+        }
+        // A missing address ends the trace, as in TraceReader.
+        if (st == TraceReader::Status::End && p < end) {
+            eof = true;
+            break;
+        }
+        // An op alone at the end of the chunk ("r\n") may have its address
+        // at the start of the next one: carry it like a partial line.
+        if (st == TraceReader::Status::End && !eof) {
+            while (rec < end && trace_is_space(*rec)) ++rec;
+            end = rec;
+        }
+
+        const std::size_t consumed = static_cast<std::size_t>(end - buf.data());
+        carry = avail - consumed;
+        memmove(buf.data(), buf.data() + consumed, carry);
+    }
+
+    if (error_.empty()) flush(TraceReader::Status::End, 0);
+    gzclose(gz);
+    queue_.close();
+#else
+    (void)handle;
+#endif
+}
+
+bool TraceBatchReader::open(const char* path, std::string& err) {
+    if (CompressedTraceReader::is_compressed(path)) {
+        ztrace_ = std::make_unique<CompressedTraceReader>(path, batch_records_);
+        if (!ztrace_->is_open()) { err = ztrace_->error(); return false; }
+        return true;
+    }
+    trace_ = std::make_unique<TraceReader>(path);
+    if (!trace_->is_open()) {
+        err = trace_->error() ? trace_->error() : "unable to open file";
+        return false;
+    }
+    return true;
+}
+
+bool TraceBatchReader::next_batch(TraceBatch& out) {
+    if (ztrace_) return ztrace_->next_batch(out);
+    if (done_ || !trace_) return false;
+
+    out.addrs.resize(batch_records_);
+    out.writes.resize(batch_records_);
+    out.status = TraceReader::Status::Ok;
+    out.bad_op = 0;
+
+    Cache::Op op;
+    uint32_t addr;
+    std::size_t n = 0;
+    while (n < batch_records_) {
+        const TraceReader::Status st = trace_->next(op, addr, out.bad_op);
+        if (st != TraceReader::Status::Ok) {
+            out.status = st;
+            done_ = true;
+            break;
+        }
+        out.addrs[n]  = addr;
+        out.writes[n] = (op == Cache::Op::Write) ? 1 : 0;
+        ++n;
+    }
+    out.addrs.resize(n);
+    out.writes.resize(n);
+    return true;
+}
+
+bool load_decoded_trace(const char* path, DecodedTrace& out, std::string& err) {
+    TraceBatchReader reader;
+    if (!reader.open(path, err)) return false;
+
+    TraceBatch batch;
+    while (reader.next_batch(batch)) {
+        out.addrs.insert(out.addrs.end(), batch.addrs.begin(), batch.addrs.end());
+        out.writes.insert(out.writes.end(), batch.writes.begin(), batch.writes.end());
+        if (batch.status == TraceReader::Status::BadOp) {
+            err = std::string("Unknown request type ") + batch.bad_op;
+            return false;
+        }
+    }
+    if (!reader.error().empty()) { err = reader.error(); return false; }
+    return true;
+}
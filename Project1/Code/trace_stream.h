@@ -0,0 +1,98 @@
+#ifndef TRACE_STREAM_H
+#define TRACE_STREAM_H
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cache.h"
+#include "trace.h"
+#include "batch_queue.h"
+
+// Streaming reader for gzip-compressed text traces (e.g. gcc_trace.txt.gz).
+// A background thread inflates the file chunk by chunk, decodes records with
+// the same text decoder as TraceReader, and hands fixed-size batches to the
+// simulation thread through a bounded BatchQueue, so decompression overlaps
+// simulation and the inflated trace never touches disk.
+// Requires zlib (HAVE_ZLIB); without it, is_open() is false with an error.
+
+struct TraceBatch {
+    std::vector<uint32_t> addrs;
+    std::vector<uint8_t>  writes;                              // 1 -> Op::Write
+    TraceReader::Status   status = TraceReader::Status::Ok;    // End/BadOp after this batch
+    char                  bad_op = 0;
+};
+
+class CompressedTraceReader {
+public:
+    explicit CompressedTraceReader(const char* path,
+                                   std::size_t batch_records = 1u << 16,
+                                   std::size_t queue_depth   = 4);
+    ~CompressedTraceReader();
+
+    CompressedTraceReader(const CompressedTraceReader&) = delete;
+    CompressedTraceReader& operator=(const CompressedTraceReader&) = delete;
+
+    // True if 'path' starts with the gzip magic bytes.
+    static bool is_compressed(const char* path);
+
+    bool is_open() const { return open_; }
+
+    // Blocks for the next batch. Returns false once every batch was consumed.
+    // The last batch carries the terminating status (End or BadOp).
+    bool next_batch(TraceBatch& out) { return queue_.pop(out); }
+
+    // Producer-side failure (read/inflate error, binary payload), valid after
+    // next_batch() has returned false.
+    const std::string& error() const { return error_; }
+
+private:
+    void produce_(void* gz);
+
+    BatchQueue<TraceBatch> queue_;
+    std::size_t            batch_records_;
+    std::thread            worker_;
+    bool                   open_ = false;
+    std::string            error_;
+};
+
+// Uniform batch interface over any trace file: gzip input goes through
+// CompressedTraceReader, everything else through a mapped TraceReader whose
+// records are decoded into batches on the calling thread.
+class TraceBatchReader {
+public:
+    explicit TraceBatchReader(std::size_t batch_records = 1u << 16)
+    : batch_records_(batch_records ? batch_records : 1) {}
+
+    // On failure returns false and fills 'err'.
+    bool open(const char* path, std::string& err);
+
+    // Same contract as CompressedTraceReader::next_batch.
+    bool next_batch(TraceBatch& out);
+
+    // Producer-side failure, valid after next_batch() has returned false.
+    std::string error() const { return ztrace_ ? ztrace_->error() : std::string(); }
+
+private:
+    std::size_t                            batch_records_;
+    std::unique_ptr<TraceReader>           trace_;
+    std::unique_ptr<CompressedTraceReader> ztrace_;
+    bool                                   done_ = false;
+};
+
+// Whole trace decoded into memory (5 bytes per record), shared read-only by
+// parallel runners.
+struct DecodedTrace {
+    std::vector<uint32_t> addrs;
+    std::vector<uint8_t>  writes;   // 1 -> Op::Write
+    std::size_t size() const { return addrs.size(); }
+};
+
+// Decode all of 'path' into 'out'. On failure returns false and fills 'err'
+// (a malformed record reports "Unknown request type <c>").
+bool load_decoded_trace(const char* path, DecodedTrace& out, std::string& err);
+
+#endif // TRACE_STREAM_H
@@ -0,0 +1,80 @@
+/***********************************************************************************
+ * File:        victim_cache.cc
+ * Author:      Connor Savugot
+ * Created:     2025-09-21
+ * Updated:     2025-09-21
+ * Version:     1.0
+ *
+ * Description: Fully-associative LRU victim cache: hash-indexed lookup, O(1)
+ *              recency list and a free-slot stack for blocks swapped back.
+ ***********************************************************************************/
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "victim_cache.h"
+
+VictimCache::VictimCache(uint32_t entries)
+: index_(entries), blocks_(entries, 0), dirty_(entries, 0),
+  prev_(entries, kNil), next_(entries, kNil) {
+    free_.reserve(entries);
+    for (uint32_t s = entries; s > 0; --s) free_.push_back(s - 1);
+}
+
+void VictimCache::unlink_(uint32_t s) {
+    const uint32_t p = prev_[s];
+    const uint32_t n = next_[s];
+    if (p != kNil) next_[p] = n; else head_ = n;
+    if (n != kNil) prev_[n] = p; else tail_ = p;
+}
+
+void VictimCache::push_front_(uint32_t s) {
+    prev_[s] = kNil;
+    next_[s] = head_;
+    if (head_ != kNil) prev_[head_] = s; else tail_ = s;
+    head_ = s;
+}
+
+bool VictimCache::take(uint32_t block_addr, bool& dirty) {
+    const int s = index_.find(block_addr);
+    if (s < 0) return false;
+    const uint32_t slot = static_cast<uint32_t>(s);
+    dirty = dirty_[slot] != 0;
+    index_.erase(block_addr);
+    unlink_(slot);
+    free_.push_back(slot);
+    used_ -= 1;
+    return true;
+}
+
+bool VictimCache::insert(uint32_t block_addr, bool dirty, uint32_t& out_addr, bool& out_dirty) {
+    bool displaced = false;
+    uint32_t slot;
+    if (!free_.empty()) {
+        slot = free_.back();
+        free_.pop_back();
+        used_ += 1;
+    } else {
+        slot = tail_;
+        out_addr  = blocks_[slot];
+        out_dirty = dirty_[slot] != 0;
+        displaced = true;
+        index_.erase(out_addr);
+        unlink_(slot);
+    }
+    blocks_[slot] = block_addr;
+    dirty_[slot]  = dirty ? 1 : 0;
+    index_.insert(block_addr, slot);
+    push_front_(slot);
+    return displaced;
+}
+
+void VictimCache::contents(std::vector<uint32_t>& blocks, std::vector<bool>& dirty) const {
+    blocks.clear();
+    dirty.clear();
+    for (uint32_t s = head_; s != kNil; s = next_[s]) {
+        blocks.push_back(blocks_[s]);
+        dirty.push_back(dirty_[s] != 0);
+    }
+}
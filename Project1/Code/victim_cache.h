@@ -0,0 +1,52 @@
+#ifndef VICTIM_CACHE_H
+#define VICTIM_CACHE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "fa_index.h"
+
+// Small fully-associative victim cache (Jouppi) behind a Cache: it holds the
+// lines that cache evicts, and a miss that finds its block here swaps it back
+// instead of fetching from the level below. Entries are block addresses with
+// a dirty bit, looked up through a FullyAssocIndex and kept in an O(1) LRU
+// list, so a probe is one hash lookup however many entries there are.
+
+class VictimCache {
+public:
+    explicit VictimCache(uint32_t entries);
+
+    uint32_t capacity() const { return static_cast<uint32_t>(blocks_.size()); }
+    uint32_t size()     const { return used_; }
+
+    // Remove 'block_addr' if present (it moves back into the cache); returns
+    // whether it was, and its dirty bit.
+    bool take(uint32_t block_addr, bool& dirty);
+
+    // Insert a line the cache evicted (not already present) as MRU. When
+    // full, the LRU entry is displaced into out_addr/out_dirty and true is
+    // returned; it then leaves the cache for good.
+    bool insert(uint32_t block_addr, bool dirty, uint32_t& out_addr, bool& out_dirty);
+
+    // Resident block addresses, MRU first, and their dirty bits.
+    void contents(std::vector<uint32_t>& blocks, std::vector<bool>& dirty) const;
+
+private:
+    static constexpr uint32_t kNil = 0xFFFFFFFFu;
+
+    FullyAssocIndex       index_;      // block address -> slot
+    std::vector<uint32_t> blocks_;
+    std::vector<uint8_t>  dirty_;
+    std::vector<uint32_t> prev_;
+    std::vector<uint32_t> next_;
+    std::vector<uint32_t> free_;       // unused slots (stack)
+    uint32_t              head_ = kNil;   // MRU slot
+    uint32_t              tail_ = kNil;   // LRU slot
+    uint32_t              used_ = 0;
+
+    void unlink_(uint32_t s);
+    void push_front_(uint32_t s);
+};
+
+#endif // VICTIM_CACHE_H
@@ -0,0 +1,54 @@
+#ifndef WRITE_BUFFER_H
+#define WRITE_BUFFER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Coalescing write buffer between a Cache and the level below it. Holds the
+// block addresses of pending writes (write-throughs and writebacks) in FIFO
+// order; a write to a block that is already pending merges into that entry.
+// When the buffer is full the oldest entry drains to the next level. Buffers
+// are small (a handful of entries), so lookups are a linear scan.
+
+class WriteBuffer {
+public:
+    explicit WriteBuffer(uint32_t entries) : capacity_(entries) { pending_.reserve(entries); }
+
+    uint32_t capacity() const { return capacity_; }
+    bool     empty()    const { return pending_.empty(); }
+    bool     full()     const { return pending_.size() >= capacity_; }
+
+    // True if 'block_addr' is pending (the new write coalesces into it).
+    bool contains(uint32_t block_addr) const {
+        for (uint32_t a : pending_) if (a == block_addr) return true;
+        return false;
+    }
+
+    // Queue a new entry; the caller drains the oldest first if full().
+    void push(uint32_t block_addr) { pending_.push_back(block_addr); }
+
+    // Remove and return the oldest entry. Precondition: !empty().
+    uint32_t pop_oldest() {
+        const uint32_t a = pending_.front();
+        pending_.erase(pending_.begin());
+        return a;
+    }
+
+    // Remove 'block_addr' if pending (a read to it must see the write first).
+    bool take(uint32_t block_addr) {
+        for (std::size_t i = 0; i < pending_.size(); ++i) {
+            if (pending_[i] == block_addr) {
+                pending_.erase(pending_.begin() + static_cast<std::ptrdiff_t>(i));
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    uint32_t              capacity_;
+    std::vector<uint32_t> pending_;   // oldest first
+};
+
+#endif // WRITE_BUFFER_H